@@ -0,0 +1,101 @@
+#include "aho_corasick.hpp"
+#include <cctype>
+
+// ==================== CONSTRUCTION ====================
+
+AhoCorasick::AhoCorasick(const std::vector<std::string>& patterns, bool case_insensitive)
+    : num_patterns(patterns.size()) {
+    auto fold = [case_insensitive](unsigned char c) {
+        return case_insensitive ? static_cast<unsigned char>(std::tolower(c)) : c;
+    };
+
+    // Every byte used by a pattern gets its own class; all other bytes share
+    // class 0. Folded letters reuse the class of their lowercase form.
+    byte_class.fill(0);
+    num_classes = 1;
+    for (const std::string& p : patterns) {
+        for (char ch : p) {
+            unsigned char c = fold(static_cast<unsigned char>(ch));
+            if (byte_class[c] == 0) byte_class[c] = static_cast<std::uint16_t>(num_classes++);
+        }
+    }
+    if (case_insensitive) {
+        for (int c = 'A'; c <= 'Z'; c++) byte_class[c] = byte_class[std::tolower(c)];
+    }
+    const size_t k = static_cast<size_t>(num_classes);
+
+    // 1. Trie. Missing edges are -1 until the failure pass fills them.
+    goto_table.assign(k, -1);
+    std::vector<std::vector<std::int32_t>> ends(1);
+    for (size_t id = 0; id < patterns.size(); id++) {
+        std::int32_t state = 0;
+        for (char ch : patterns[id]) {
+            size_t slot = static_cast<size_t>(state) * k + byte_class[static_cast<unsigned char>(ch)];
+            if (goto_table[slot] < 0) {
+                goto_table[slot] = static_cast<std::int32_t>(ends.size());
+                goto_table.insert(goto_table.end(), k, -1);
+                ends.emplace_back();
+            }
+            state = goto_table[slot];
+        }
+        ends[state].push_back(static_cast<std::int32_t>(id));
+    }
+    const size_t n = ends.size();
+
+    output_begin.assign(1, 0);
+    for (const auto& ids : ends) {
+        output_ids.insert(output_ids.end(), ids.begin(), ids.end());
+        output_begin.push_back(static_cast<std::uint32_t>(output_ids.size()));
+    }
+
+    // 2. Failure links in BFS order. A missing edge of u becomes the edge of
+    //    fail(u), which is shallower and therefore already complete.
+    std::vector<std::int32_t> fail(n, 0);
+    output_link.assign(n, -1);
+    std::vector<std::int32_t> queue;
+    queue.reserve(n);
+    for (size_t c = 0; c < k; c++) {
+        std::int32_t& v = goto_table[c];
+        if (v < 0) {
+            v = 0;
+        } else {
+            queue.push_back(v);
+        }
+    }
+    auto has_outputs = [this](std::int32_t s) { return output_begin[s + 1] > output_begin[s]; };
+    for (size_t head = 0; head < queue.size(); head++) {
+        std::int32_t u = queue[head];
+        std::int32_t f = fail[u];
+        output_link[u] = has_outputs(f) ? f : output_link[f];
+        for (size_t c = 0; c < k; c++) {
+            std::int32_t& v = goto_table[static_cast<size_t>(u) * k + c];
+            std::int32_t via_fail = goto_table[static_cast<size_t>(f) * k + c];
+            if (v < 0) {
+                v = via_fail;
+            } else {
+                fail[v] = via_fail;
+                queue.push_back(v);
+            }
+        }
+    }
+}
+
+// ==================== MATCHING ====================
+
+std::vector<int> AhoCorasick::matched_patterns(std::string_view text) const {
+    std::vector<char> seen(num_patterns, 0);
+    size_t found = 0;
+    scan(text, [&](int id, size_t) {
+        if (!seen[id]) {
+            seen[id] = 1;
+            found++;
+        }
+    });
+
+    std::vector<int> ids;
+    ids.reserve(found);
+    for (size_t id = 0; id < num_patterns; id++) {
+        if (seen[id]) ids.push_back(static_cast<int>(id));
+    }
+    return ids;
+}
@@ -0,0 +1,86 @@
+#ifndef AHO_CORASICK_HPP
+#define AHO_CORASICK_HPP
+
+#include <vector>
+#include <string>
+#include <string_view>
+#include <array>
+#include <cstdint>
+
+/**
+ * @class AhoCorasick
+ * @brief Multi-pattern exact string matcher
+ *
+ * Built once from a pattern list, then finds every occurrence of every
+ * pattern in a single left-to-right pass over the text, independent of how
+ * many patterns are loaded. The goto function is a dense table indexed by
+ * state and byte class with failure transitions already folded in, so each
+ * input byte costs one table lookup. Output links chain each state to the
+ * next state on its failure path that ends a pattern.
+ *
+ * With case folding enabled, upper- and lowercase ASCII letters share a
+ * byte class, so folding costs nothing at scan time.
+ */
+class AhoCorasick {
+public:
+    /**
+     * @brief Build the automaton
+     * @param patterns Patterns to search for; pattern ids are their indices.
+     *        Duplicate patterns keep separate ids, and an empty pattern
+     *        matches at every position.
+     * @param case_insensitive Fold ASCII letters in patterns and text
+     */
+    explicit AhoCorasick(const std::vector<std::string>& patterns, bool case_insensitive = false);
+
+    size_t pattern_count() const { return num_patterns; }
+    size_t state_count() const { return output_link.size(); }
+
+    // Low-level stepping API
+    int start_state() const { return 0; }
+    int next_state(int state, unsigned char c) const {
+        return goto_table[static_cast<size_t>(state) * num_classes + byte_class[c]];
+    }
+
+    /**
+     * @brief Call f(pattern_id) for every pattern ending at this state
+     */
+    template<typename F>
+    void for_each_output(int state, F&& f) const {
+        for (int s = state; s >= 0; s = output_link[s]) {
+            for (std::uint32_t i = output_begin[s]; i < output_begin[s + 1]; i++) {
+                f(output_ids[i]);
+            }
+        }
+    }
+
+    /**
+     * @brief Call f(pattern_id, end) for every occurrence in text
+     *
+     * end is the offset one past the last byte of the occurrence.
+     */
+    template<typename F>
+    void scan(std::string_view text, F&& f) const {
+        int state = start_state();
+        for_each_output(state, [&](int id) { f(id, size_t{0}); });
+        for (size_t i = 0; i < text.size(); i++) {
+            state = next_state(state, static_cast<unsigned char>(text[i]));
+            for_each_output(state, [&](int id) { f(id, i + 1); });
+        }
+    }
+
+    /**
+     * @brief Ids of all patterns that occur somewhere in text, ascending
+     */
+    std::vector<int> matched_patterns(std::string_view text) const;
+
+private:
+    size_t num_patterns;
+    int num_classes;
+    std::array<std::uint16_t, 256> byte_class;  // 0 = bytes in no pattern
+    std::vector<std::int32_t> goto_table;     // (state * num_classes + cls) -> state
+    std::vector<std::int32_t> output_link;    // next state on the failure path with outputs, or -1
+    std::vector<std::uint32_t> output_begin;  // state -> range in output_ids
+    std::vector<std::int32_t> output_ids;
+};
+
+#endif // AHO_CORASICK_HPP
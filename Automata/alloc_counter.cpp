@@ -0,0 +1,149 @@
+#include "alloc_counter.hpp"
+#include <atomic>
+#include <cstddef>
+#include <cstdlib>
+#include <new>
+
+#ifdef _WIN32
+#include <malloc.h>
+#endif
+
+namespace {
+    std::atomic<std::uint64_t> allocations{0};
+    thread_local std::uint64_t thread_count = 0;
+}
+
+namespace alloc_counter {
+
+bool enabled() {
+#ifdef AUTOMATA_COUNT_ALLOCATIONS
+    return true;
+#else
+    return false;
+#endif
+}
+
+std::uint64_t total_allocations() {
+    return allocations.load(std::memory_order_relaxed);
+}
+
+std::uint64_t thread_allocations() {
+    return thread_count;
+}
+
+}  // namespace alloc_counter
+
+#ifdef AUTOMATA_COUNT_ALLOCATIONS
+
+// ==================== REPLACEMENT OPERATORS ====================
+// Every replaceable form is defined here rather than left to the library's
+// defaults: sized deletes in particular would otherwise go through a
+// version that may not reach counted_free()
+
+namespace {
+    void* counted_alloc(std::size_t size, std::size_t alignment) {
+        allocations.fetch_add(1, std::memory_order_relaxed);
+        thread_count++;
+        if (size == 0) size = 1;
+#ifdef _WIN32
+        return _aligned_malloc(size, alignment);
+#else
+        if (alignment <= alignof(std::max_align_t)) return std::malloc(size);
+        return std::aligned_alloc(alignment, (size + alignment - 1) & ~(alignment - 1));
+#endif
+    }
+
+    void counted_free(void* p) {
+#ifdef _WIN32
+        _aligned_free(p);
+#else
+        std::free(p);
+#endif
+    }
+}
+
+void* operator new(std::size_t size) {
+    void* p = counted_alloc(size, alignof(std::max_align_t));
+    if (!p) throw std::bad_alloc();
+    return p;
+}
+
+void* operator new(std::size_t size, std::align_val_t alignment) {
+    void* p = counted_alloc(size, static_cast<std::size_t>(alignment));
+    if (!p) throw std::bad_alloc();
+    return p;
+}
+
+void* operator new[](std::size_t size) {
+    return ::operator new(size);
+}
+
+void* operator new[](std::size_t size, std::align_val_t alignment) {
+    return ::operator new(size, alignment);
+}
+
+void* operator new(std::size_t size, const std::nothrow_t&) noexcept {
+    return counted_alloc(size, alignof(std::max_align_t));
+}
+
+void* operator new(std::size_t size, std::align_val_t alignment, const std::nothrow_t&) noexcept {
+    return counted_alloc(size, static_cast<std::size_t>(alignment));
+}
+
+void* operator new[](std::size_t size, const std::nothrow_t&) noexcept {
+    return counted_alloc(size, alignof(std::max_align_t));
+}
+
+void* operator new[](std::size_t size, std::align_val_t alignment, const std::nothrow_t&) noexcept {
+    return counted_alloc(size, static_cast<std::size_t>(alignment));
+}
+
+void operator delete(void* p) noexcept {
+    counted_free(p);
+}
+
+void operator delete(void* p, std::align_val_t) noexcept {
+    counted_free(p);
+}
+
+void operator delete(void* p, std::size_t) noexcept {
+    counted_free(p);
+}
+
+void operator delete(void* p, std::size_t, std::align_val_t) noexcept {
+    counted_free(p);
+}
+
+void operator delete(void* p, const std::nothrow_t&) noexcept {
+    counted_free(p);
+}
+
+void operator delete(void* p, std::align_val_t, const std::nothrow_t&) noexcept {
+    counted_free(p);
+}
+
+void operator delete[](void* p) noexcept {
+    counted_free(p);
+}
+
+void operator delete[](void* p, std::align_val_t) noexcept {
+    counted_free(p);
+}
+
+void operator delete[](void* p, std::size_t) noexcept {
+    counted_free(p);
+}
+
+void operator delete[](void* p, std::size_t, std::align_val_t) noexcept {
+    counted_free(p);
+}
+
+void operator delete[](void* p, const std::nothrow_t&) noexcept {
+    counted_free(p);
+}
+
+void operator delete[](void* p, std::align_val_t, const std::nothrow_t&) noexcept {
+    counted_free(p);
+}
+
+#endif // AUTOMATA_COUNT_ALLOCATIONS
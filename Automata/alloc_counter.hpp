@@ -0,0 +1,33 @@
+#ifndef ALLOC_COUNTER_HPP
+#define ALLOC_COUNTER_HPP
+
+#include <cstdint>
+
+/**
+ * @brief Global heap allocation counters, for checking that the analysis
+ *        paths do not allocate per message
+ *
+ * Building with AUTOMATA_COUNT_ALLOCATIONS defined replaces the global
+ * operator new/delete with counting versions. Without it the counters
+ * stay at zero and enabled() is false.
+ */
+namespace alloc_counter {
+
+/**
+ * @brief Whether this build counts allocations
+ */
+bool enabled();
+
+/**
+ * @brief operator new calls from all threads since startup
+ */
+std::uint64_t total_allocations();
+
+/**
+ * @brief operator new calls from the calling thread since it started
+ */
+std::uint64_t thread_allocations();
+
+}  // namespace alloc_counter
+
+#endif // ALLOC_COUNTER_HPP
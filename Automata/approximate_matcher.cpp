@@ -1,47 +1,47 @@
 #include "approximate_matcher.hpp"
+#include "scratch_arena.hpp"
 #include <regex>
 #include <unordered_set>
 #include <queue>
 #include <iomanip>
 #include <fstream>
 
-// ========== PRIVATE METHODS ==========
-
-std::string ApproximateMatcher::preprocess_message(const std::string& message) {
-    std::string result = message;
-    std::unordered_map<char, char> leet_map = {
-        {'1', 'i'}, {'0', 'o'}, {'3', 'e'}, {'4', 'a'}, {'5', 's'},
-        {'7', 't'}, {'@', 'a'}, {'$', 's'}, {'!', 'i'}
-    };
-
-    for (char& c : result) {
-        auto it = leet_map.find(std::tolower(c));
-        if (it != leet_map.end()) c = it->second;
+namespace {
+    double similarity(size_t word_length, size_t pattern_length, int dist) {
+        return (1.0 - static_cast<double>(dist) / std::max(word_length, pattern_length)) * 100;
     }
+}
 
-    result.erase(std::remove_if(result.begin(), result.end(),
-        [](char c) { return !std::isalnum(c) && !std::isspace(c); }), result.end());
+// ========== PRIVATE METHODS ==========
 
+std::string ApproximateMatcher::preprocess_message(std::string_view message) {
+    std::string result(message.size(), '\0');
+    result.resize(normalize_text(message, result.data()));
     return result;
 }
 
 int ApproximateMatcher::levenshtein_distance(const std::string& s1, const std::string& s2) {
-    int m = s1.size(), n = s2.size();
-    std::vector<std::vector<int>> dp(m + 1, std::vector<int>(n + 1));
+    if (s2.size() <= MyersPattern::MAX_LENGTH) {
+        return myers_distance(MyersPattern(s2), s1);
+    }
 
-    for (int i = 0; i <= m; ++i) dp[i][0] = i;
-    for (int j = 0; j <= n; ++j) dp[0][j] = j;
+    // Long patterns: two-row DP
+    int m = s1.size(), n = s2.size();
+    std::vector<int> prev(n + 1), cur(n + 1);
+    for (int j = 0; j <= n; ++j) prev[j] = j;
 
     for (int i = 1; i <= m; ++i) {
+        cur[0] = i;
         for (int j = 1; j <= n; ++j) {
             int cost = (tolower(s1[i - 1]) == tolower(s2[j - 1])) ? 0 : 1;
-            dp[i][j] = std::min({ dp[i - 1][j] + 1,
-                                  dp[i][j - 1] + 1,
-                                  dp[i - 1][j - 1] + cost });
+            cur[j] = std::min({ prev[j] + 1,
+                                cur[j - 1] + 1,
+                                prev[j - 1] + cost });
         }
+        std::swap(prev, cur);
     }
 
-    return dp[m][n];
+    return prev[n];
 }
 
 std::string ApproximateMatcher::escape_dot_label(const std::string& s) {
@@ -53,90 +53,191 @@ std::string ApproximateMatcher::escape_dot_label(const std::string& s) {
     return result;
 }
 
-std::vector<ApproximateMatcher::MatchResult> ApproximateMatcher::find_word_matches(
-    const std::string& word, const std::string& regex_pattern, int maxEdits) {
+ApproximateMatcher::CompiledPattern& ApproximateMatcher::compile_pattern(
+    const std::string& regex_pattern, int maxEdits) {
     
-    std::vector<MatchResult> matches;
+    auto it = compiled_patterns.find(std::make_pair(std::string_view(regex_pattern), maxEdits));
+    if (it != compiled_patterns.end()) return it->second;
 
-    // Simple regex match first
-    try {
-        std::regex pattern(regex_pattern, std::regex_constants::icase);
-        if (std::regex_match(word, pattern)) {
-            matches.emplace_back(word, regex_pattern, 0, 100.0);
-        } else {
-            // If not exact, compute Levenshtein distance
-            int dist = levenshtein_distance(word, regex_pattern);
-            if (dist <= maxEdits) {
-                double sim = (1.0 - static_cast<double>(dist) /
-                              std::max(word.length(), regex_pattern.length())) * 100;
-                matches.emplace_back(word, regex_pattern, dist, sim);
-            }
-        }
-    } catch (...) {
-        // invalid regex
+    CompiledPattern& compiled = compiled_patterns[std::make_pair(regex_pattern, maxEdits)];
+    compiled.literal = regex_pattern.find_first_of("\\^$.|?*+()[]{}") == std::string::npos;
+    compiled.regex = PatternCache::global().get(regex_pattern, PATTERN_ICASE);
+    if (maxEdits >= 0 && maxEdits <= LevenshteinAutomaton::MAX_EDITS) {
+        compiled.automaton = std::make_unique<LevenshteinAutomaton>(regex_pattern, maxEdits);
     }
-
-    return matches;
+    if (regex_pattern.size() <= MyersPattern::MAX_LENGTH) {
+        compiled.myers = std::make_unique<MyersPattern>(regex_pattern);
+    }
+    return compiled;
 }
 
 // ========== PUBLIC METHODS ==========
 
+int ApproximateMatcher::match_word(std::string_view word, const std::string& regex_pattern, int maxEdits) {
+    CompiledPattern& compiled = compile_pattern(regex_pattern, maxEdits);
+    if (!compiled.regex) return -1;
+
+    // Simple regex match first (a literal pattern only matches at distance 0,
+    // which the distance engines below report the same way)
+    if (!compiled.literal && compiled.regex->match(word)) return 0;
+
+    // If not exact, run the Levenshtein automaton, else bit-parallel or DP
+    int dist;
+    if (compiled.automaton) {
+        dist = compiled.automaton->match(word);
+    } else if (compiled.myers) {
+        dist = myers_distance(*compiled.myers, word);
+    } else {
+        dist = levenshtein_distance(std::string(word), regex_pattern);
+    }
+    if ((dist >= 0 && dist <= maxEdits) || (compiled.literal && dist == 0)) return dist;
+    return -1;
+}
+
+int ApproximateMatcher::first_match_distance(std::string_view message, const std::string& regex_pattern, int maxEdits) {
+    int found = -1;
+    for_each_word(message, [&](std::string_view w, const Token&) {
+        if (found < 0) found = match_word(w, regex_pattern, maxEdits);
+    });
+    return found;
+}
+
 std::vector<ApproximateMatcher::MatchResult> ApproximateMatcher::find_matches(
-    const std::string& message, 
+    std::string_view message, 
     const std::string& regex_pattern, 
     int maxEdits) {
     
     std::vector<MatchResult> all_matches;
     
-    // Preprocess the message
-    std::string processed_text = preprocess_message(message);
-    
     // ADD VERBOSE CHECK HERE:
     if (verbose_mode) {
         std::cout << "\nPattern: \"" << regex_pattern << "\"" << std::endl;
         std::cout << "Max edits: " << maxEdits << std::endl;
-        std::cout << "Preprocessed: \"" << processed_text << "\"" << std::endl << std::endl;
+        std::cout << "Preprocessed: \"" << preprocess_message(message) << "\"" << std::endl << std::endl;
     }
     
-    // Tokenize the message into words
-    std::istringstream iss(processed_text);
-    std::string word;
+    // Normalize and tokenize the message (allocation-free)
     int word_count = 0;
     
-    while (iss >> word) {
+    for_each_word(message, [&](std::string_view w, const Token& token) {
         word_count++;
         
         // ADD VERBOSE CHECK HERE:
         if (verbose_mode) {
-            std::cout << "Word " << word_count << ": \"" << word << "\" -> ";
+            std::cout << "Word " << word_count << ": \"" << w << "\" -> ";
         }
         
         // Find matches for this word
-        auto word_matches = find_word_matches(word, regex_pattern, maxEdits);
+        int dist = match_word(w, regex_pattern, maxEdits);
         
-        if (!word_matches.empty()) {
+        if (dist >= 0) {
+            all_matches.emplace_back(w, regex_pattern, dist, similarity(w.size(), regex_pattern.size(), dist),
+                                     token.offset, token.text.size());
+            
             // ADD VERBOSE CHECK HERE:
             if (verbose_mode) {
-                for (const auto& match : word_matches) {
-                    std::cout << "MATCH: \"" << match.original << "\" -> \"" 
-                             << match.matched_pattern << "\" (distance: " 
-                             << match.distance << ")" << std::endl;
-                }
+                const MatchResult& match = all_matches.back();
+                std::cout << "MATCH: \"" << match.original << "\" -> \"" 
+                         << match.matched_pattern << "\" (distance: " 
+                         << match.distance << ")" << std::endl;
             }
-            all_matches.insert(all_matches.end(), word_matches.begin(), word_matches.end());
         } else {
             // ADD VERBOSE CHECK HERE:
             if (verbose_mode) {
                 std::cout << "NO MATCH" << std::endl;
             }
         }
-    }
+    });
     
     return all_matches;
 }
 
 
 
+std::vector<ApproximateMatcher::MatchResult> ApproximateMatcher::find_matches(
+    std::string_view message,
+    const std::vector<std::string>& regex_patterns,
+    int maxEdits) {
+    
+    std::vector<MatchResult> all_matches;
+
+    // Verbose output is per pattern, so keep the per-pattern trace
+    if (verbose_mode) {
+        for (const auto& pattern : regex_patterns) {
+            auto matches = find_matches(message, pattern, maxEdits);
+            all_matches.insert(all_matches.end(), matches.begin(), matches.end());
+        }
+        return all_matches;
+    }
+
+    // Literal patterns of up to 64 bytes are scored together in SIMD
+    // batches; the rest go through match_word one by one. All scratch
+    // lives on the thread's arena.
+    ScratchScope scope;
+    std::pmr::memory_resource* arena = scope.resource();
+    std::pmr::vector<const CompiledPattern*> compiled(arena);
+    std::pmr::vector<const MyersPattern*> batch(arena);
+    std::pmr::vector<size_t> batch_ids(arena);
+    for (size_t i = 0; i < regex_patterns.size(); i++) {
+        const CompiledPattern& cp = compile_pattern(regex_patterns[i], maxEdits);
+        compiled.push_back(&cp);
+        if (cp.regex && cp.literal && cp.myers) {
+            batch.push_back(cp.myers.get());
+            batch_ids.push_back(i);
+        }
+    }
+
+    // Matches are found word-major; matched words are copied into one
+    // string so results are only built for the final, pattern-major list
+    struct Hit {
+        size_t pattern;
+        size_t word_begin;
+        size_t word_length;
+        int distance;
+        size_t token_offset;
+        size_t token_length;
+    };
+    std::pmr::vector<Hit> hits(arena);
+    std::pmr::string matched_words(arena);
+    std::pmr::vector<int> distances(batch.size(), arena);
+
+    for_each_word(message, [&](std::string_view w, const Token& token) {
+        myers_distance_batch(batch.data(), batch.size(), w, distances.data());
+
+        size_t word_begin = std::string::npos;
+        auto add_hit = [&](size_t pattern, int dist) {
+            if (word_begin == std::string::npos) {
+                word_begin = matched_words.size();
+                matched_words += w;
+            }
+            hits.push_back({pattern, word_begin, w.size(), dist, token.offset, token.text.size()});
+        };
+
+        size_t next_batched = 0;
+        for (size_t i = 0; i < regex_patterns.size(); i++) {
+            if (next_batched < batch_ids.size() && batch_ids[next_batched] == i) {
+                int dist = distances[next_batched++];
+                if (dist <= maxEdits || dist == 0) add_hit(i, dist);
+            } else if (compiled[i]->regex) {
+                int dist = match_word(w, regex_patterns[i], maxEdits);
+                if (dist >= 0) add_hit(i, dist);
+            }
+        }
+    });
+
+    all_matches.reserve(hits.size());
+    for (size_t i = 0; i < regex_patterns.size() && all_matches.size() < hits.size(); i++) {
+        for (const Hit& hit : hits) {
+            if (hit.pattern != i) continue;
+            std::string_view original = std::string_view(matched_words).substr(hit.word_begin, hit.word_length);
+            all_matches.emplace_back(original, regex_patterns[i], hit.distance,
+                                     similarity(original.size(), regex_patterns[i].size(), hit.distance),
+                                     hit.token_offset, hit.token_length);
+        }
+    }
+    return all_matches;
+}
+
 std::string ApproximateMatcher::toDotRegexFSM(const std::string& regex_pattern, int maxEdits) {
     // First, convert regex to NFA (simplified for visualization)
     std::string dot = "digraph ApproxFSM {\n";
@@ -2,6 +2,7 @@
 #define APPROXIMATE_MATCHER_HPP
 
 #include <string>
+#include <string_view>
 #include <vector>
 #include <unordered_map>
 #include <set>
@@ -12,6 +13,15 @@
 #include <iostream>
 #include <iomanip>
 #include <fstream>
+#include <map>
+#include <memory>
+#include <memory_resource>
+#include "levenshtein_automaton.hpp"
+#include "edit_distance.hpp"
+#include "pattern_cache.hpp"
+#include "tokenizer.hpp"
+#include "text_normalizer.hpp"
+#include "scratch_arena.hpp"
 
 /**
  * @class ApproximateMatcher
@@ -31,32 +41,117 @@ public:
      * @brief Represents a matching result with similarity metrics
      */
     struct MatchResult {
-        std::string original;        ///< The original word/text that was matched
+        std::string original;        ///< The matched word, as normalized for matching
         std::string matched_pattern; ///< The pattern that was matched against
         int distance;                ///< Levenshtein edit distance (0 = exact match)
         double similarity;           ///< Similarity percentage (0-100%)
+        size_t offset;               ///< Byte offset in the message of the word's first source byte
+        size_t length;               ///< Bytes from there through its last source byte
         
-        MatchResult(const std::string& orig, const std::string& matched, int dist, double sim)
-            : original(orig), matched_pattern(matched), distance(dist), similarity(sim) {}
+        MatchResult(std::string_view orig, const std::string& matched, int dist, double sim,
+                    size_t offset, size_t length)
+            : original(orig), matched_pattern(matched), distance(dist), similarity(sim),
+              offset(offset), length(length) {}
     };
 
     // INLINE CONSTRUCTOR - ADD THIS
     ApproximateMatcher(bool verbose = true) : verbose_mode(verbose) {}
 
-    std::vector<MatchResult> find_matches(const std::string& message, 
+    std::vector<MatchResult> find_matches(std::string_view message,
                                           const std::string& regex_pattern, 
                                           int maxEdits = 2);
 
+    /**
+     * @brief Match a message against several patterns at once
+     *
+     * Same results as calling find_matches once per pattern and
+     * concatenating them (pattern-major order), but the message is
+     * preprocessed and tokenized once, and each word is scored against all
+     * literal patterns in one SIMD batch.
+     */
+    std::vector<MatchResult> find_matches(std::string_view message,
+                                          const std::vector<std::string>& regex_patterns,
+                                          int maxEdits = 2);
+
+
+    /**
+     * @brief Match one word against one pattern without building results
+     * @return Edit distance (0 for a regex match), or -1 if it does not match
+     */
+    int match_word(std::string_view word, const std::string& regex_pattern, int maxEdits = 2);
+
+    /**
+     * @brief Edit distance of the first word of the message that matches
+     *        the pattern, or -1; find_matches()[0].distance without the
+     *        result vector
+     */
+    int first_match_distance(std::string_view message, const std::string& regex_pattern, int maxEdits = 2);
+
+    /**
+     * @brief Call f(word, source) for each word find_matches() scores
+     *
+     * The message is normalized once (normalize_text) and split with the
+     * Tokenizer; a token that normalizes to nothing yields no word. source
+     * is the word's span in the original message, from its first to its
+     * last contributing byte, found through the normalizer's offset map.
+     * Buffers come from the thread's scratch arena.
+     */
+    template <typename F>
+    static void for_each_word(std::string_view message, F&& f) {
+        if (message.empty()) return;
+        ScratchScope scope;
+        std::pmr::memory_resource* arena = scope.resource();
+        char* normalized = static_cast<char*>(arena->allocate(message.size(), alignof(char)));
+        auto* offsets = static_cast<std::uint32_t*>(
+            arena->allocate(message.size() * sizeof(std::uint32_t), alignof(std::uint32_t)));
+        size_t length = normalize_text(message, normalized, offsets);
+
+        Tokenizer::for_each(std::string_view(normalized, length), [&](const Token& word) {
+            size_t begin = offsets[word.offset];
+            size_t end = offsets[word.end() - 1] + 1;
+            f(word.text, Token{message.substr(begin, end - begin), begin});
+        });
+    }
     
     std::string toDotRegexFSM(const std::string& regex_pattern, int maxEdits);
-    std::string preprocess_message(const std::string& message);
+    std::string preprocess_message(std::string_view message);
+
+    /**
+     * @brief preprocess_message() for one character: NORMALIZE_TABLE, so
+     *        letters are lowercased, leet digits/symbols become letters and
+     *        other punctuation is dropped ('\0')
+     */
+    static char normalize_char(char c) {
+        return static_cast<char>(NORMALIZE_TABLE[static_cast<unsigned char>(c)]);
+    }
 
     void set_verbose(bool verbose) { verbose_mode = verbose; }
 
 private:
-    std::vector<MatchResult> find_word_matches(const std::string& word, 
-                                               const std::string& regex_pattern, 
-                                               int maxEdits);
+    /**
+     * @struct CompiledPattern
+     * @brief Regex and distance engines for one (pattern, max edits) pair
+     */
+    struct CompiledPattern {
+        std::shared_ptr<const CompiledRegex> regex;  ///< From PatternCache::global(); null if invalid
+        bool literal = false;  ///< No regex metacharacters: regex_match is case-insensitive equality
+        std::unique_ptr<LevenshteinAutomaton> automaton;  ///< Null when maxEdits is outside 0..MAX_EDITS
+        std::unique_ptr<MyersPattern> myers;              ///< Null for patterns over 64 bytes
+    };
+
+    // Looks patterns up by string_view, so a hit copies no key
+    struct PatternKeyLess {
+        using is_transparent = void;
+        template <typename A, typename B>
+        bool operator()(const A& a, const B& b) const {
+            int c = std::string_view(a.first).compare(b.first);
+            return c < 0 || (c == 0 && a.second < b.second);
+        }
+    };
+    std::map<std::pair<std::string, int>, CompiledPattern, PatternKeyLess> compiled_patterns;
+
+    CompiledPattern& compile_pattern(const std::string& regex_pattern, int maxEdits);
+
     std::string escape_dot_label(const std::string& s);
     
     // ADD THIS PRIVATE METHOD DECLARATION
@@ -0,0 +1,88 @@
+#include "blocklist.hpp"
+#include <cctype>
+#include <filesystem>
+#include <fstream>
+
+namespace {
+    // Letters and digits, lowercased: what a token is matched on
+    std::string match_key(std::string_view text) {
+        std::string key;
+        for (char ch : text) {
+            unsigned char c = static_cast<unsigned char>(ch);
+            if (std::isalnum(c)) key += static_cast<char>(std::tolower(c));
+        }
+        return key;
+    }
+
+    // A cache is usable if it is a sound automaton whose word ids are all
+    // in the list
+    bool cache_matches(const MappedDFA& dfa, size_t num_words) {
+        if (!dfa.is_loaded() || !dfa.verify()) return false;
+        bool ok = true;
+        for (int s = 0; s < dfa.get_num_states() && ok; s++) {
+            dfa.for_each_output(s, [&](int id) { ok = ok && id >= 0 && static_cast<size_t>(id) < num_words; });
+        }
+        return ok;
+    }
+}
+
+std::shared_ptr<const Blocklist> Blocklist::load(const std::string& path, std::string& error) {
+    std::ifstream in(path);
+    if (!in) {
+        error = "cannot open " + path;
+        return nullptr;
+    }
+
+    auto blocklist = std::make_shared<Blocklist>();
+    std::vector<std::string> keys;
+    std::string line;
+    while (std::getline(in, line)) {
+        size_t first = line.find_first_not_of(" \t\r");
+        if (first == std::string::npos || line[first] == '#') continue;
+        std::string word = line.substr(first, line.find_last_not_of(" \t\r") - first + 1);
+        std::string key = match_key(word);
+        if (key.empty()) continue;
+        blocklist->word_list.push_back(word);
+        keys.push_back(key);
+    }
+    if (blocklist->word_list.size() > MAX_WORDS) {
+        error = path + " has more than " + std::to_string(MAX_WORDS) + " words";
+        return nullptr;
+    }
+
+    // Reuse the compiled lexicon unless the list changed after it was written
+    const std::string cache = cache_path(path);
+    std::error_code ec;
+    auto cache_time = std::filesystem::last_write_time(cache, ec);
+    if (!ec && cache_time >= std::filesystem::last_write_time(path, ec) && !ec) {
+        blocklist->compiled = std::make_unique<MappedDFA>(cache);
+        if (cache_matches(*blocklist->compiled, keys.size())) return blocklist;
+    }
+
+    if (!save_compiled_dfa(build_lexicon_dfa(keys), cache)) {
+        error = "cannot write " + cache;
+        return nullptr;
+    }
+    blocklist->compiled = std::make_unique<MappedDFA>(cache);
+    if (!blocklist->compiled->is_loaded()) {
+        error = cache + ": " + blocklist->compiled->error();
+        return nullptr;
+    }
+    return blocklist;
+}
+
+int Blocklist::match(std::string_view token) const {
+    int state = compiled->get_start_state();
+    if (state < 0) return -1;
+    for (char ch : token) {
+        unsigned char c = static_cast<unsigned char>(ch);
+        if (!std::isalnum(c)) continue;
+        state = compiled->next_state(state, static_cast<unsigned char>(std::tolower(c)));
+        if (state < 0) return -1;
+    }
+    int word = -1;
+    compiled->for_each_output(state, [&](int id) {
+        if (word < 0) word = id;
+    });
+    return word;
+}
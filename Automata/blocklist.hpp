@@ -0,0 +1,52 @@
+#ifndef BLOCKLIST_HPP
+#define BLOCKLIST_HPP
+
+#include "dfa_serialization.hpp"
+#include <memory>
+#include <string>
+#include <string_view>
+#include <vector>
+
+/**
+ * @class Blocklist
+ * @brief A word list file, matched against whole tokens through its
+ *        compiled lexicon DFA
+ *
+ * The lexicon (build_lexicon_dfa() over the words, lowercased and stripped
+ * to their letters and digits, the way tokens are matched) is cached next
+ * to the list as "<list>.adfa" in the save_compiled_dfa() format. Loading
+ * maps the cache when it is at least as new as the list and rebuilds it
+ * otherwise, so a large list is compiled once rather than on every start.
+ * Immutable once loaded: analyzers on several threads share one.
+ */
+class Blocklist {
+public:
+    /// BatchResults stores word ids in 16 bits, next to the built-in words
+    static constexpr size_t MAX_WORDS = 60000;
+
+    /**
+     * @brief Load a word list: one word per line, skipping blank lines and
+     *        lines starting with '#'
+     * @param error Set to the reason when loading fails
+     * @return null if the list cannot be read, is too long, or its lexicon
+     *         cannot be written or mapped
+     */
+    static std::shared_ptr<const Blocklist> load(const std::string& path, std::string& error);
+
+    static std::string cache_path(const std::string& path) { return path + ".adfa"; }
+
+    const std::vector<std::string>& words() const { return word_list; }
+    const MappedDFA& lexicon() const { return *compiled; }
+
+    /**
+     * @brief Index of the word a token spells (ignoring case and
+     *        non-alphanumeric bytes), or -1
+     */
+    int match(std::string_view token) const;
+
+private:
+    std::vector<std::string> word_list;
+    std::unique_ptr<MappedDFA> compiled;
+};
+
+#endif // BLOCKLIST_HPP
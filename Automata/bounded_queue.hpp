@@ -0,0 +1,149 @@
+#ifndef BOUNDED_QUEUE_HPP
+#define BOUNDED_QUEUE_HPP
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <thread>
+#include <utility>
+
+/**
+ * @class BoundedQueue
+ * @brief Fixed-capacity lock-free multi-producer/multi-consumer queue
+ *
+ * Vyukov's bounded MPMC ring: every cell carries a sequence number, so a
+ * push or pop is one CAS on the head or tail index plus one store to the
+ * cell, and producers never contend with consumers. Works for any mix of
+ * producer and consumer counts, so the same queue serves SPSC and MPMC
+ * stages.
+ *
+ * try_push/try_pop never block. push/pop spin briefly and then sleep on
+ * an atomic event counter (C++20 atomic wait), so idle pipeline stages do
+ * not burn a core while another stage is busy or blocked on I/O. After
+ * close(), push fails and pop drains what is left, then fails.
+ */
+template <typename T>
+class BoundedQueue {
+public:
+    /**
+     * @param capacity Rounded up to a power of two (at least 2)
+     */
+    explicit BoundedQueue(size_t capacity) {
+        size_t size = 2;
+        while (size < capacity) size <<= 1;
+        mask = size - 1;
+        cells = std::make_unique<Cell[]>(size);
+        for (size_t i = 0; i < size; i++) {
+            cells[i].sequence.store(i, std::memory_order_relaxed);
+        }
+    }
+
+    BoundedQueue(const BoundedQueue&) = delete;
+    BoundedQueue& operator=(const BoundedQueue&) = delete;
+
+    bool try_push(T& value) {
+        size_t pos = tail.load(std::memory_order_relaxed);
+        for (;;) {
+            Cell& cell = cells[pos & mask];
+            size_t seq = cell.sequence.load(std::memory_order_acquire);
+            intptr_t diff = static_cast<intptr_t>(seq) - static_cast<intptr_t>(pos);
+            if (diff == 0) {
+                if (tail.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed)) {
+                    cell.value = std::move(value);
+                    cell.sequence.store(pos + 1, std::memory_order_release);
+                    signal();
+                    return true;
+                }
+            } else if (diff < 0) {
+                return false;  // full
+            } else {
+                pos = tail.load(std::memory_order_relaxed);
+            }
+        }
+    }
+
+    bool try_pop(T& out) {
+        size_t pos = head.load(std::memory_order_relaxed);
+        for (;;) {
+            Cell& cell = cells[pos & mask];
+            size_t seq = cell.sequence.load(std::memory_order_acquire);
+            intptr_t diff = static_cast<intptr_t>(seq) - static_cast<intptr_t>(pos + 1);
+            if (diff == 0) {
+                if (head.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed)) {
+                    out = std::move(cell.value);
+                    cell.sequence.store(pos + mask + 1, std::memory_order_release);
+                    signal();
+                    return true;
+                }
+            } else if (diff < 0) {
+                return false;  // empty
+            } else {
+                pos = head.load(std::memory_order_relaxed);
+            }
+        }
+    }
+
+    /**
+     * @brief Push, waiting while the queue is full
+     * @return false if the queue was closed
+     */
+    bool push(T value) {
+        for (int spins = 0;; spins++) {
+            uint32_t seen = events.load(std::memory_order_acquire);
+            if (closed.load(std::memory_order_acquire)) return false;
+            if (try_push(value)) return true;
+            wait(seen, spins);
+        }
+    }
+
+    /**
+     * @brief Pop, waiting while the queue is empty
+     * @return false once the queue is closed and drained
+     */
+    bool pop(T& out) {
+        for (int spins = 0;; spins++) {
+            uint32_t seen = events.load(std::memory_order_acquire);
+            if (try_pop(out)) return true;
+            if (closed.load(std::memory_order_acquire)) return try_pop(out);
+            wait(seen, spins);
+        }
+    }
+
+    void close() {
+        closed.store(true, std::memory_order_release);
+        signal();
+    }
+
+private:
+    static constexpr int SPIN_LIMIT = 64;
+
+    struct Cell {
+        std::atomic<size_t> sequence;
+        T value;
+    };
+
+    std::unique_ptr<Cell[]> cells;
+    size_t mask;
+
+    // Separate cache lines: producers touch tail, consumers head
+    alignas(64) std::atomic<size_t> head{0};
+    alignas(64) std::atomic<size_t> tail{0};
+    alignas(64) std::atomic<uint32_t> events{0};  // bumped on every state change
+    std::atomic<bool> closed{false};
+
+    void signal() {
+        events.fetch_add(1, std::memory_order_release);
+        events.notify_all();
+    }
+
+    void wait(uint32_t seen, int spins) {
+        if (spins < SPIN_LIMIT) {
+            std::this_thread::yield();
+        } else {
+            events.wait(seen, std::memory_order_acquire);  // returns once events != seen
+        }
+    }
+};
+
+#endif // BOUNDED_QUEUE_HPP
@@ -0,0 +1,121 @@
+#include "bracket_validator.hpp"
+#include "cpu_features.hpp"
+#include <array>
+#include <bit>
+#include <cstdint>
+
+#if HAVE_X86_SIMD
+#include <immintrin.h>
+#endif
+
+namespace {
+    // Byte -> the opener a closer matches, the byte itself for an opener,
+    // 0 for anything else
+    constexpr std::array<char, 256> make_bracket_table() {
+        std::array<char, 256> table{};
+        for (char c : {'(', '[', '{', '<'}) table[static_cast<unsigned char>(c)] = c;
+        table[static_cast<unsigned char>(')')] = '(';
+        table[static_cast<unsigned char>(']')] = '[';
+        table[static_cast<unsigned char>('}')] = '{';
+        table[static_cast<unsigned char>('>')] = '<';
+        return table;
+    }
+
+    constexpr std::array<char, 256> BRACKET = make_bracket_table();
+
+    constexpr size_t AVX2_BLOCK = 32;
+
+    /**
+     * Fixed-capacity bracket stack: open brackets and where they are
+     */
+    class BracketStack {
+    public:
+        // Feed one bracket byte; false if it would nest too deep
+        bool step(char c, size_t offset) {
+            char open = BRACKET[static_cast<unsigned char>(c)];
+            if (open == c) {
+                if (depth == MAX_BRACKET_DEPTH) {
+                    overflow_offset = offset;
+                    return false;
+                }
+                brackets[depth] = c;
+                offsets[depth] = offset;
+                depth++;
+            } else if (depth > 0 && brackets[depth - 1] == open) {
+                depth--;
+            }
+            return true;
+        }
+
+        BracketValidation result(bool overflowed) const {
+            if (overflowed) return {false, true, overflow_offset};
+            if (depth > 0) return {false, false, offsets[0]};
+            return {true, false, BracketValidation::npos};
+        }
+
+    private:
+        size_t depth = 0;
+        size_t overflow_offset = 0;
+        char brackets[MAX_BRACKET_DEPTH];
+        size_t offsets[MAX_BRACKET_DEPTH];
+    };
+}
+
+// ==================== AVX2 KERNEL ====================
+
+#if HAVE_X86_SIMD
+// Feeds the brackets of whole 32-byte blocks; returns false on overflow,
+// sets consumed
+TARGET_AVX2
+static bool scan_brackets_avx2(std::string_view text, BracketStack& stack, size_t& consumed) {
+    const __m256i targets[8] = {
+        _mm256_set1_epi8('('), _mm256_set1_epi8(')'), _mm256_set1_epi8('['), _mm256_set1_epi8(']'),
+        _mm256_set1_epi8('{'), _mm256_set1_epi8('}'), _mm256_set1_epi8('<'), _mm256_set1_epi8('>'),
+    };
+
+    size_t i = 0;
+    for (; i + AVX2_BLOCK <= text.size(); i += AVX2_BLOCK) {
+        __m256i v = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(text.data() + i));
+        __m256i hit = _mm256_cmpeq_epi8(v, targets[0]);
+        for (int t = 1; t < 8; t++) hit = _mm256_or_si256(hit, _mm256_cmpeq_epi8(v, targets[t]));
+
+        for (std::uint32_t mask = static_cast<std::uint32_t>(_mm256_movemask_epi8(hit)); mask; mask &= mask - 1) {
+            size_t at = i + static_cast<size_t>(std::countr_zero(mask));
+            if (!stack.step(text[at], at)) {
+                consumed = i;
+                return false;
+            }
+        }
+    }
+    consumed = i;
+    return true;
+}
+#endif
+
+// ==================== DISPATCH ====================
+
+static BracketValidation validate(std::string_view text, bool use_simd) {
+    BracketStack stack;
+    size_t i = 0;
+#if HAVE_X86_SIMD
+    if (use_simd && text.size() >= AVX2_BLOCK) {
+        if (!scan_brackets_avx2(text, stack, i)) return stack.result(true);
+    }
+#else
+    (void)use_simd;
+#endif
+    for (; i < text.size(); i++) {
+        if (BRACKET[static_cast<unsigned char>(text[i])] && !stack.step(text[i], i)) {
+            return stack.result(true);
+        }
+    }
+    return stack.result(false);
+}
+
+BracketValidation validate_brackets(std::string_view text) {
+    return validate(text, cpu_has_avx2());
+}
+
+BracketValidation validate_brackets_scalar(std::string_view text) {
+    return validate(text, false);
+}
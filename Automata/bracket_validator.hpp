@@ -0,0 +1,48 @@
+#ifndef BRACKET_VALIDATOR_HPP
+#define BRACKET_VALIDATOR_HPP
+
+#include <cstddef>
+#include <string>
+#include <string_view>
+
+/**
+ * @file bracket_validator.hpp
+ * @brief Allocation-free balanced-bracket check
+ *
+ * Gives the same answer as PDA::simulate(): (), [], {} and <> must nest,
+ * a closer that does not match the innermost open bracket is ignored, and
+ * the text is accepted when no bracket is left open. Bracket bytes are
+ * located with an AVX2 compare-and-movemask kernel when the CPU has it,
+ * so runs of text without brackets cost one compare per 32 bytes; the
+ * stack is a fixed-size array on the call stack.
+ */
+
+/**
+ * @struct BracketValidation
+ * @brief Result of validate_brackets()
+ */
+struct BracketValidation {
+    bool valid;                 ///< Whether every bracket was closed
+    bool depth_exceeded;        ///< Rejected for nesting deeper than MAX_BRACKET_DEPTH
+    size_t error_offset;        ///< First unclosed (or too deep) opener; npos when valid
+
+    static constexpr size_t npos = std::string::npos;
+};
+
+/// Deepest nesting validate_brackets() tracks; deeper input is rejected
+inline constexpr size_t MAX_BRACKET_DEPTH = 1024;
+
+/**
+ * @brief Check that the brackets in text are balanced
+ *
+ * Matches PDA::simulate() on any input nesting at most MAX_BRACKET_DEPTH
+ * deep. Makes no allocation.
+ */
+BracketValidation validate_brackets(std::string_view text);
+
+/**
+ * @brief validate_brackets() without the AVX2 kernel, byte by byte
+ */
+BracketValidation validate_brackets_scalar(std::string_view text);
+
+#endif // BRACKET_VALIDATOR_HPP
@@ -1,6 +1,14 @@
 // chat_analyzer.cpp
 #include "chat_analyzer.hpp"
+#include "bounded_queue.hpp"
+#include "text_normalizer.hpp"
 #include <iostream>
+#include <sstream>
+#include <thread>
+#include <atomic>
+#include <vector>
+#include <map>
+#include <algorithm>
 
 #define RED     "\033[31m"
 #define GREEN   "\033[32m"
@@ -8,55 +16,153 @@
 #define CYAN    "\033[36m"
 #define RESET   "\033[0m"
 
-void ChatLogAnalyzer::analyze_file(const std::string& filename) {
-    std::ifstream file(filename);
-    if (!file.is_open()) {
+namespace {
+    // A run of consecutive lines; views point into the mapping, or into
+    // storage when the input is read through a buffer. storage is held by
+    // pointer: moving a short std::string moves its bytes (SSO), which would
+    // leave the views behind.
+    struct LineBatch {
+        size_t sequence = 0;
+        int first_line = 1;
+        std::vector<std::string_view> lines;
+        std::unique_ptr<std::string> storage;
+    };
+
+    // Formatted report for one batch
+    struct BatchReport {
+        size_t sequence = 0;
+        std::string text;
+    };
+}
+
+void ChatLogAnalyzer::analyze_file(const std::string& filename, unsigned workers) {
+    // Mapped when possible; lines are views into the file, not copies
+    LineSource source(filename);
+    if (!source.is_open()) {
         std::cout << RED << "Error: Could not open file " << filename << RESET << "\n";
         return;
     }
 
-    std::string line;
-    int line_number = 1;
+    if (workers == 0) workers = std::max(1u, std::thread::hardware_concurrency());
+    const bool mapped = source.is_mapped();
 
     std::cout << CYAN << "\n=== CHAT LOG ANALYSIS ===\n" << RESET;
-    
-    while (std::getline(file, line)) {
-        std::cout << "\n" << YELLOW << "Message " << line_number << ":" << RESET << " " << line << "\n";
-        
-        auto result = analyzer.analyze_message(line);
-        print_analysis_result(result);
-        
-        line_number++;
+
+    // A few batches of slack per worker keeps everyone busy without
+    // letting the reader run far ahead
+    BoundedQueue<LineBatch> batches(workers * 4);
+    BoundedQueue<BatchReport> reports(workers * 4);
+
+    // ------------------ reader ------------------
+    std::thread reader([&] {
+        std::string_view line;
+        size_t sequence = 0;
+        int line_number = 1;
+        bool more = true;
+        while (more) {
+            LineBatch batch;
+            batch.sequence = sequence++;
+            batch.first_line = line_number;
+            std::vector<size_t> ends;  // line ends within storage (buffered input)
+            if (!mapped) batch.storage = std::make_unique<std::string>();
+            while (batch.lines.size() + ends.size() < LINES_PER_BATCH && (more = source.next(line))) {
+                if (mapped) {
+                    batch.lines.push_back(line);
+                } else {
+                    batch.storage->append(line);
+                    ends.push_back(batch.storage->size());
+                }
+            }
+            // storage is complete, so views into it stay valid from here on
+            size_t start = 0;
+            for (size_t end : ends) {
+                batch.lines.emplace_back(batch.storage->data() + start, end - start);
+                start = end;
+            }
+            if (batch.lines.empty()) break;
+            line_number += static_cast<int>(batch.lines.size());
+            batches.push(std::move(batch));
+        }
+        batches.close();
+    });
+
+    // ------------------ workers ------------------
+    std::vector<std::thread> pool;
+    std::atomic<unsigned> running{workers};
+    for (unsigned w = 0; w < workers; w++) {
+        pool.emplace_back([&] {
+            ToxicityAnalyzer analyzer(false, blocklist);  // the per-word trace would interleave
+            ToxicityAnalyzer::BatchResults results;        // reused, so batches allocate no results
+            LineBatch batch;
+            while (batches.pop(batch)) {
+                analyzer.analyze_batch(batch.lines, results);
+                std::ostringstream out;
+                int line_number = batch.first_line;
+                for (size_t i = 0; i < batch.lines.size(); i++) {
+                    out << "\n" << YELLOW << "Message " << line_number++ << ":" << RESET << " " << batch.lines[i] << "\n";
+                    print_analysis_result(out, results, i, batch.lines[i], analyzer.pattern_names());
+                }
+                reports.push(BatchReport{batch.sequence, out.str()});
+            }
+            if (running.fetch_sub(1) == 1) reports.close();
+        });
+    }
+
+    // ------------------ writer ------------------
+    // Reports arrive out of order; hold early ones until their turn
+    std::map<size_t, std::string> pending;
+    size_t next_sequence = 0;
+    BatchReport report;
+    while (reports.pop(report)) {
+        pending.emplace(report.sequence, std::move(report.text));
+        for (auto it = pending.begin(); it != pending.end() && it->first == next_sequence;
+             it = pending.erase(it), next_sequence++) {
+            std::cout << it->second;
+        }
     }
+    std::cout.flush();
 
-    file.close();
+    reader.join();
+    for (auto& t : pool) t.join();
 }
 
-void ChatLogAnalyzer::print_analysis_result(const ToxicityAnalyzer::AnalysisResult& result) {
+void ChatLogAnalyzer::print_analysis_result(std::ostream& out, const ToxicityAnalyzer::BatchResults& results, size_t i,
+                                            std::string_view message, const std::vector<std::string>& pattern_names) {
+    const int score = results.scores[i];
     std::string color = RESET;
-    if (result.toxicity_score >= 70) color = RED;
-    else if (result.toxicity_score >= 30) color = YELLOW;
+    if (score >= 70) color = RED;
+    else if (score >= 30) color = YELLOW;
     else color = GREEN;
 
-    std::cout << color << "Toxicity Score: " << result.toxicity_score << "/100" << RESET << "\n";
-    
-    if (!result.exact_matches.empty()) {
-        std::cout << "Exact Matches: ";
-        for (const auto& match : result.exact_matches) {
-            std::cout << RED << match << RESET << " ";
+    out << color << "Toxicity Score: " << score << "/100" << RESET << "\n";
+
+    // Exact matches, then approximate ones
+    const size_t begin = results.match_begin[i];
+    const size_t approx_begin = begin + results.exact_counts[i];
+    const size_t end = results.match_begin[i + 1];
+
+    if (approx_begin > begin) {
+        out << "Exact Matches: ";
+        for (size_t m = begin; m < approx_begin; m++) {
+            out << RED << pattern_names[results.match_pattern_ids[m]] << RESET << " ";
         }
-        std::cout << "\n";
+        out << "\n";
     }
 
-    if (!result.approx_matches.empty()) {
-        std::cout << "Approximate Matches: ";
-        for (const auto& match : result.approx_matches) {
-            std::cout << YELLOW << match.original << " (-> " << match.matched_pattern
-                     << ", dist=" << match.distance << ")" << RESET << " ";
+    if (end > approx_begin) {
+        out << "Approximate Matches: ";
+        std::string word;
+        for (size_t m = approx_begin; m < end; m++) {
+            // The word as normalized for matching, recovered from its source span
+            std::string_view source = message.substr(results.match_offsets[m], results.match_lengths[m]);
+            word.resize(source.size());
+            word.resize(normalize_text(source, word.data()));
+            out << YELLOW << word << " (-> " << pattern_names[results.match_pattern_ids[m]]
+                << ", dist=" << static_cast<int>(results.match_distances[m]) << ")" << RESET << " ";
         }
-        std::cout << "\n";
+        out << "\n";
     }
 
-    std::cout << "Structure: " << (result.valid_structure ? GREEN : RED) 
-              << result.structure_type << RESET << "\n";
+    out << "Structure: " << (results.valid_structure[i] ? GREEN : RED)
+        << (results.valid_structure[i] ? "Valid" : "Invalid") << RESET << "\n";
 }
\ No newline at end of file
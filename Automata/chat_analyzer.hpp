@@ -3,17 +3,44 @@
 #define CHAT_ANALYZER_HPP
 
 #include "toxicity_analyzer.hpp"
-#include <fstream>
+#include "mapped_file.hpp"
+#include <ostream>
+#include <memory>
 #include <string>
+#include <string_view>
+#include <vector>
 
+/**
+ * @class ChatLogAnalyzer
+ * @brief Analyzes a chat log (one message per line) on a thread pipeline
+ *
+ * reader -> N workers -> writer. The reader cuts the file into batches of
+ * lines, each worker owns its own ToxicityAnalyzer, analyzes a batch with
+ * analyze_batch() into results it reuses and formats the report, and the
+ * writer prints batches in sequence-number order, so
+ * the output is identical to a single-threaded run. Stages are joined by
+ * bounded lock-free queues, which caps the memory in flight.
+ */
 class ChatLogAnalyzer {
 private:
-    ToxicityAnalyzer analyzer;
+    std::shared_ptr<const Blocklist> blocklist;
 
-    void print_analysis_result(const ToxicityAnalyzer::AnalysisResult& result);
+    // Report for message i of a batch, as analyze_message() would give it
+    static void print_analysis_result(std::ostream& out, const ToxicityAnalyzer::BatchResults& results, size_t i,
+                                      std::string_view message, const std::vector<std::string>& pattern_names);
 
 public:
-    void analyze_file(const std::string& filename);
+    static constexpr size_t LINES_PER_BATCH = 64;
+
+    /**
+     * @param blocklist Extra words every worker's analyzer matches
+     */
+    explicit ChatLogAnalyzer(std::shared_ptr<const Blocklist> blocklist = nullptr) : blocklist(std::move(blocklist)) {}
+
+    /**
+     * @param workers Worker threads; 0 uses one per hardware thread
+     */
+    void analyze_file(const std::string& filename, unsigned workers = 0);
 };
 
-#endif
\ No newline at end of file
+#endif
@@ -0,0 +1,51 @@
+#ifndef CPU_FEATURES_HPP
+#define CPU_FEATURES_HPP
+
+/**
+ * @file cpu_features.hpp
+ * @brief Runtime CPU feature detection for SIMD kernel dispatch
+ *
+ * SIMD kernels are compiled with a per-function target attribute
+ * (TARGET_AVX2) so the rest of the program keeps the baseline instruction
+ * set; callers check cpu_has_avx2() once and pick the kernel at runtime.
+ */
+
+#if defined(__x86_64__) || defined(__i386__) || defined(_M_X64) || defined(_M_IX86)
+#define HAVE_X86_SIMD 1
+#if defined(_MSC_VER) && !defined(__clang__)
+#include <intrin.h>
+#define TARGET_AVX2
+#else
+#define TARGET_AVX2 __attribute__((target("avx2")))
+#endif
+#else
+#define HAVE_X86_SIMD 0
+#define TARGET_AVX2
+#endif
+
+/**
+ * @brief Whether the running CPU (and OS) supports AVX2
+ */
+inline bool cpu_has_avx2() {
+#if HAVE_X86_SIMD && defined(_MSC_VER) && !defined(__clang__)
+    static const bool supported = [] {
+        int info[4];
+        __cpuid(info, 0);
+        if (info[0] < 7) return false;
+        __cpuid(info, 1);
+        bool osxsave = (info[2] & (1 << 27)) != 0;
+        bool avx = (info[2] & (1 << 28)) != 0;
+        if (!osxsave || !avx || (_xgetbv(0) & 0x6) != 0x6) return false;
+        __cpuidex(info, 7, 0);
+        return (info[1] & (1 << 5)) != 0;
+    }();
+    return supported;
+#elif HAVE_X86_SIMD
+    static const bool supported = __builtin_cpu_supports("avx2");
+    return supported;
+#else
+    return false;
+#endif
+}
+
+#endif // CPU_FEATURES_HPP
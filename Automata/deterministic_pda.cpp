@@ -0,0 +1,249 @@
+#include "deterministic_pda.hpp"
+#include "scratch_arena.hpp"
+#include <algorithm>
+#include <cstdint>
+#include <map>
+#include <memory_resource>
+#include <tuple>
+
+namespace {
+    constexpr size_t EPSILON = 256;
+    constexpr size_t COLUMNS = 257;
+
+    std::string describe_input(size_t column) {
+        if (column == EPSILON) return "epsilon";
+        if (column >= 33 && column <= 126) return std::string("'") + static_cast<char>(column) + "'";
+        static const char* hex = "0123456789abcdef";
+        return std::string("byte 0x") + hex[column >> 4] + hex[column & 15];
+    }
+}
+
+// ==================== COMPILATION ====================
+
+DeterministicPDA::DeterministicPDA(const PDA& pda) : start(pda.get_start_state()) {
+    const std::vector<PDANode>& nodes = pda.get_nodes();
+    const size_t n = nodes.size();
+    if (start < 0 || static_cast<size_t>(start) >= n) {
+        compile_error = "start state out of range";
+        return;
+    }
+
+    // Stack alphabet: the bottom marker and every symbol popped or pushed,
+    // then a column for the empty stack, which only pop-free moves match
+    std::string symbols(1, PDA::STACK_BOTTOM);
+    std::array<int, 256> symbol_index;
+    symbol_index.fill(-1);
+    symbol_index[static_cast<unsigned char>(PDA::STACK_BOTTOM)] = 0;
+    auto add_symbol = [&](char c) {
+        int& index = symbol_index[static_cast<unsigned char>(c)];
+        if (index < 0) {
+            index = static_cast<int>(symbols.size());
+            symbols += c;
+        }
+    };
+    for (const PDANode& node : nodes) {
+        for (const auto& [input, pop, push, to] : node.transitions) {
+            if (pop) add_symbol(pop);
+            for (char c : push) add_symbol(c);
+        }
+    }
+    if (symbols.size() > 255) {
+        compile_error = "more than 255 stack symbols";
+        return;
+    }
+    bottom = 0;
+    empty = static_cast<std::uint8_t>(symbols.size());
+    num_symbols = static_cast<int>(symbols.size()) + 1;
+    auto describe_top = [&](size_t top) {
+        return top == empty ? std::string("an empty stack") : std::string("'") + symbols[top] + "' on top";
+    };
+
+    // Identical moves share an action, so bytes that do the same thing
+    // end up in one class
+    std::map<std::tuple<int, bool, std::string>, std::uint32_t> action_index;
+    std::vector<Action> actions(1);  // Id 0 is no move
+    auto intern = [&](int to, char pop, const std::string& push) {
+        auto [it, added] = action_index.try_emplace({to, pop != 0, push}, static_cast<std::uint32_t>(actions.size()));
+        if (added) {
+            Action action;
+            action.to = to;
+            action.pops = pop != 0;
+            action.push_length = static_cast<std::uint8_t>(push.size());
+            // The first push character ends up on top, so store back to front
+            std::vector<std::uint8_t> symbols_pushed;
+            for (auto c = push.rbegin(); c != push.rend(); ++c) {
+                symbols_pushed.push_back(static_cast<std::uint8_t>(symbol_index[static_cast<unsigned char>(*c)]));
+            }
+            if (symbols_pushed.size() <= 2) {
+                std::copy(symbols_pushed.begin(), symbols_pushed.end(), action.push);
+            } else {
+                action.push_begin = static_cast<std::uint32_t>(push_pool.size());
+                push_pool.insert(push_pool.end(), symbols_pushed.begin(), symbols_pushed.end());
+            }
+            actions.push_back(action);
+        }
+        return it->second;
+    };
+
+    // Every (state, input column, top) a move applies to; a second,
+    // different move on the same cell is nondeterminism
+    const size_t k = static_cast<size_t>(num_symbols);
+    std::vector<std::uint32_t> cells(n * COLUMNS * k, 0);
+    for (size_t s = 0; s < n; s++) {
+        for (const auto& [input, pop, push, to] : nodes[s].transitions) {
+            if (to < 0 || static_cast<size_t>(to) >= n) continue;
+            if (push.size() > 255) {
+                compile_error = "state " + std::to_string(s) + ": push longer than 255 symbols";
+                return;
+            }
+            std::uint32_t id = intern(to, pop, push);
+            size_t column = input == 0 ? EPSILON : static_cast<unsigned char>(input);
+            size_t first = pop ? static_cast<size_t>(symbol_index[static_cast<unsigned char>(pop)]) : 0;
+            size_t last = pop ? first + 1 : k;
+            for (size_t top = first; top < last; top++) {
+                std::uint32_t& cell = cells[(s * COLUMNS + column) * k + top];
+                if (cell && cell != id) {
+                    compile_error = "state " + std::to_string(s) + ": two moves on " +
+                                    describe_input(column) + " with " + describe_top(top);
+                    return;
+                }
+                cell = id;
+            }
+        }
+        for (size_t top = 0; top < k; top++) {
+            if (!cells[(s * COLUMNS + EPSILON) * k + top]) continue;
+            for (size_t column = 0; column < EPSILON; column++) {
+                if (cells[(s * COLUMNS + column) * k + top]) {
+                    compile_error = "state " + std::to_string(s) + ": epsilon move competes with a move on " +
+                                    describe_input(column) + " with " + describe_top(top);
+                    return;
+                }
+            }
+        }
+    }
+
+    // Byte classes: bytes whose columns match across all states and tops
+    std::map<std::vector<std::uint32_t>, int> class_of;
+    std::vector<std::uint32_t> column_cells(n * k);
+    for (size_t b = 0; b < 256; b++) {
+        for (size_t s = 0; s < n; s++) {
+            std::copy_n(&cells[(s * COLUMNS + b) * k], k, &column_cells[s * k]);
+        }
+        auto [it, added] = class_of.try_emplace(column_cells, num_classes);
+        if (added) num_classes++;
+        byte_class[b] = static_cast<std::uint8_t>(it->second);
+    }
+
+    row_size = (static_cast<size_t>(num_classes) + 1) * k;
+    if (n * row_size > UINT32_MAX) {
+        compile_error = "dispatch table too large";
+        return;
+    }
+
+    // Fill in each action's view of its target state
+    std::vector<std::uint8_t> has_epsilon(n, 0);
+    for (size_t s = 0; s < n; s++) {
+        for (size_t top = 0; top < k; top++) has_epsilon[s] |= cells[(s * COLUMNS + EPSILON) * k + top] != 0;
+    }
+    auto resolve = [&](Action action) {
+        if (action.to >= 0) {
+            action.row = static_cast<std::uint32_t>(action.to * row_size);
+            action.to_final = pda.is_final_state(action.to) ? 1 : 0;
+            action.to_epsilon = has_epsilon[action.to];
+        }
+        return action;
+    };
+    for (Action& action : actions) action = resolve(action);
+    Action into_start;
+    into_start.to = start;
+    start_action = resolve(into_start);
+
+    table.assign(n * row_size, Action{});
+    for (size_t s = 0; s < n; s++) {
+        for (size_t b = 0; b < 256; b++) {
+            for (size_t top = 0; top < k; top++) {
+                table[s * row_size + byte_class[b] * k + top] = actions[cells[(s * COLUMNS + b) * k + top]];
+            }
+        }
+        for (size_t top = 0; top < k; top++) {
+            table[s * row_size + num_classes * k + top] = actions[cells[(s * COLUMNS + EPSILON) * k + top]];
+        }
+    }
+    compiled = true;
+}
+
+// ==================== RUN ====================
+
+DeterministicPDA::Result DeterministicPDA::run(std::string_view input, size_t max_depth) const {
+    Result result;
+    result.reject_offset = input.size();
+    if (!compiled) return result;
+
+    // stack[1 .. depth] is the stack, bottom first, and top caches
+    // stack[depth]. stack[0] holds the empty-stack symbol and is never
+    // popped. The loop works on raw pointers and locals: stores through a
+    // byte pointer could alias anything else.
+    ScratchScope scope;
+    std::uint8_t* const stack = static_cast<std::uint8_t*>(scope.resource()->allocate(max_depth + 2, 1));
+    stack[0] = empty;
+    stack[1] = bottom;
+    size_t depth = 1;
+    std::uint8_t top = bottom;
+
+    const Action* const cells = table.data();
+    const std::uint8_t* const pool = push_pool.data();
+    const size_t epsilon_column = static_cast<size_t>(num_classes) * num_symbols;
+    size_t row = start_action.row;
+    bool in_final = start_action.to_final;
+    bool has_epsilon = start_action.to_epsilon;
+    size_t moves = 0;
+    bool limit_hit = false;
+
+    auto apply = [&](const Action& action) {
+        if (action.pops | action.push_length) {
+            depth -= action.pops;
+            if (depth + action.push_length > max_depth) {
+                limit_hit = true;
+                return false;
+            }
+            const std::uint8_t* push = action.push_length <= 2 ? action.push : pool + action.push_begin;
+            for (std::uint8_t k = 0; k < action.push_length; k++) stack[++depth] = push[k];
+            top = stack[depth];
+        }
+        row = action.row;
+        in_final = action.to_final;
+        has_epsilon = action.to_epsilon;
+        moves++;
+        return true;
+    };
+
+    auto finish = [&](size_t reject_offset, bool accepted) {
+        result.accepted = accepted;
+        result.limit_hit = limit_hit;
+        result.reject_offset = reject_offset;
+        result.configurations = moves;
+        return result;
+    };
+
+    // An epsilon cycle would spin forever, so a chain of epsilon moves is
+    // cut off, as a limit hit, after a fixed budget of moves
+    const size_t epsilon_budget = 2 * max_depth + table.size() / row_size * num_symbols;
+
+    // Each round follows the epsilon moves from the current state, then
+    // reads a byte. Kept as one loop (no helper for the epsilon moves) so
+    // the locals stay in registers.
+    for (size_t pos = 0;; pos++) {
+        bool accepting = in_final;
+        for (size_t steps = 0; has_epsilon; steps++) {
+            const Action& action = cells[row + epsilon_column + top];
+            if (action.to < 0) break;
+            if (steps == epsilon_budget) limit_hit = true;
+            if (limit_hit || !apply(action)) return finish(pos == 0 ? 0 : pos - 1, false);
+            accepting |= in_final;
+        }
+        if (pos == input.size()) return finish(pos, accepting);
+
+        const Action& action = cells[row + byte_class[static_cast<unsigned char>(input[pos])] * num_symbols + top];
+        if (action.to < 0 || !apply(action)) return finish(pos, false);
+    }
+}
@@ -0,0 +1,82 @@
+#ifndef DETERMINISTIC_PDA_HPP
+#define DETERMINISTIC_PDA_HPP
+
+#include "pda_engine.hpp"
+#include "pda_runner.hpp"
+#include <array>
+#include <cstdint>
+#include <string>
+#include <string_view>
+#include <vector>
+
+/**
+ * @class DeterministicPDA
+ * @brief A deterministic PDA flattened into a dense dispatch table
+ *
+ * Compiling checks that at most one move applies for every (state, input
+ * byte, stack top), and that no input move competes with an epsilon move
+ * for the same (state, stack top). A PDA that passes runs with one table
+ * lookup per byte: actions are indexed by [state][byte class][stack top],
+ * where bytes with identical columns share a class (as in DFA::compile())
+ * and stack symbols are renumbered densely, and the stack is a flat array
+ * of symbol numbers. A cell holds everything a step needs (the next
+ * state's row, the stack change, the next state's flags), so text that
+ * leaves the stack alone costs one dependent load per byte.
+ *
+ * Semantics and acceptance (by final state, at any point of the epsilon
+ * moves after the last byte) are PDARunner's, so a PDA that does not
+ * compile can run there instead with the same results.
+ */
+class DeterministicPDA {
+public:
+    using Result = PDARunner::Result;  ///< configurations counts the moves taken
+
+    static constexpr size_t DEFAULT_MAX_DEPTH = PDARunner::DEFAULT_MAX_DEPTH;
+
+    explicit DeterministicPDA(const PDA& pda);
+
+    /**
+     * @brief Whether the PDA was deterministic; otherwise error() says
+     *        where two moves compete, and run() rejects everything
+     */
+    bool is_compiled() const { return compiled; }
+    const std::string& error() const { return compile_error; }
+
+    Result run(std::string_view input, size_t max_depth = DEFAULT_MAX_DEPTH) const;
+    bool accepts(std::string_view input) const { return run(input).accepted; }
+
+    int get_num_classes() const { return num_classes; }
+    int get_num_symbols() const { return num_symbols; }
+
+private:
+    // A table cell
+    struct Action {
+        std::int32_t to = -1;          // -1: no move
+        std::uint32_t row = 0;         // to * row_size
+        std::uint8_t pops = 0;
+        std::uint8_t push_length = 0;
+        std::uint8_t push[2] = {};     // push symbols, bottom-most first, when they fit here
+        std::uint8_t to_final = 0;
+        std::uint8_t to_epsilon = 0;   // to has epsilon moves
+        std::uint32_t push_begin = 0;  // ... else in push_pool
+    };
+
+    bool compiled = false;
+    std::string compile_error;
+
+    int start = 0;
+    int num_classes = 0;
+    int num_symbols = 0;  // stack symbols, plus one column for the empty stack
+    std::uint8_t bottom = 0;
+    std::uint8_t empty = 0;
+    std::array<std::uint8_t, 256> byte_class{};
+    Action start_action;  // A move into the start state
+    // Action of state s on class c with symbol t on top:
+    // table[s * row_size + c * num_symbols + t]. Class num_classes holds
+    // the epsilon moves.
+    std::vector<Action> table;
+    size_t row_size = 0;
+    std::vector<std::uint8_t> push_pool;
+};
+
+#endif // DETERMINISTIC_PDA_HPP
@@ -7,21 +7,136 @@
 #include <vector>
 #include <algorithm>
 #include <set>
+#include <map>
 #include <iomanip>
 
+// ------------------ DFA Compilation ------------------
+
+void DFA::compile() const {
+    if (build.compiled.load(std::memory_order_acquire)) return;
+    std::lock_guard<std::mutex> lock(build.mutex);
+    if (build.compiled.load(std::memory_order_relaxed)) return;
+    build_table();
+    build.compiled.store(true, std::memory_order_release);
+}
+
+void DFA::build_table() const {
+    const int n = static_cast<int>(states.size());
+
+    // Alphabet = every explicit symbol used by some transition. A WILDCARD
+    // transition is the state's default: it is taken on any byte the state
+    // has no explicit transition for. Bytes outside the alphabet (including
+    // the WILDCARD byte itself) therefore all fall into class 0, whose
+    // column is each state's default.
+    const unsigned char wildcard = static_cast<unsigned char>(NFA::WILDCARD);
+    std::set<unsigned char> alphabet;
+    std::vector<std::int32_t> default_column(n, -1);
+    for (int i = 0; i < n; i++) {
+        for (const auto& p : states[i].transitions) {
+            unsigned char symbol = static_cast<unsigned char>(p.first);
+            if (symbol == wildcard) {
+                default_column[i] = p.second;
+            } else {
+                alphabet.insert(symbol);
+            }
+        }
+    }
+
+    // Group alphabet symbols whose columns (target per state) are identical
+    std::map<std::vector<std::int32_t>, int> column_to_class;
+    std::vector<std::vector<std::int32_t>> class_columns;
+    byte_class.fill(0);
+    class_columns.push_back(default_column);
+    column_to_class[default_column] = 0;
+
+    for (unsigned char symbol : alphabet) {
+        std::vector<std::int32_t> column(default_column);
+        for (int i = 0; i < n; i++) {
+            auto it = states[i].transitions.find(static_cast<char>(symbol));
+            if (it != states[i].transitions.end()) column[i] = it->second;
+        }
+        auto found = column_to_class.find(column);
+        if (found == column_to_class.end()) {
+            int cls = static_cast<int>(class_columns.size());
+            found = column_to_class.emplace(column, cls).first;
+            class_columns.push_back(std::move(column));
+        }
+        byte_class[symbol] = static_cast<std::uint8_t>(found->second);
+    }
+
+    num_classes = std::max<int>(1, static_cast<int>(class_columns.size()));
+    table.assign(static_cast<size_t>(n) * num_classes, -1);
+    for (int c = 0; c < static_cast<int>(class_columns.size()); c++) {
+        for (int i = 0; i < n; i++) {
+            table[static_cast<size_t>(i) * num_classes + c] = class_columns[c][i];
+        }
+    }
+
+    accepting.assign(n, 0);
+    for (int i = 0; i < n; i++) accepting[i] = states[i].is_final ? 1 : 0;
+
+    output_begin.assign(static_cast<size_t>(n) + 1, 0);
+    output_ids.clear();
+    for (int i = 0; i < n; i++) {
+        output_begin[i] = static_cast<std::uint32_t>(output_ids.size());
+        output_ids.insert(output_ids.end(), states[i].outputs.begin(), states[i].outputs.end());
+    }
+    output_begin[n] = static_cast<std::uint32_t>(output_ids.size());
+}
+
 // ------------------ DFA Simulation ------------------
 
-bool DFA::simulate(const std::string& input) {
+bool DFA::simulate(std::string_view input) const {
+    compile();
+    if (start_state < 0 || start_state >= static_cast<int>(states.size())) return false;
+
     int current = start_state;
     for (char c : input) {
-        auto it = states[current].transitions.find(c);
-        if (it == states[current].transitions.end()) {
+        current = next_state(current, static_cast<unsigned char>(c));
+        if (current < 0) {
             // No transition for this character
             return false;
         }
-        current = it->second;
     }
-    return states[current].is_final;
+    return is_accepting(current);
+}
+
+// ------------------ Unanchored Search ------------------
+
+void DFA::build_liveness() const {
+    const int n = static_cast<int>(states.size());
+    std::vector<int> finals;
+    std::vector<ReverseLiveness::Edge> edges;
+    for (int q = 0; q < n; q++) {
+        if (is_accepting(q)) finals.push_back(q);
+        for (int c = 0; c < num_classes; c++) {
+            int to = next_state_by_class(q, c);
+            if (to >= 0) edges.push_back({q, c, to});
+        }
+    }
+    liveness = ReverseLiveness(n, byte_class, num_classes, finals, edges);
+}
+
+std::vector<std::pair<int, int>> DFA::find_all(std::string_view text) const {
+    compile();
+    if (start_state < 0 || start_state >= static_cast<int>(states.size())) return {};
+    if (!build.liveness_built.load(std::memory_order_acquire)) {
+        std::lock_guard<std::mutex> lock(build.mutex);
+        if (!build.liveness_built.load(std::memory_order_relaxed)) {
+            build_liveness();
+            build.liveness_built.store(true, std::memory_order_release);
+        }
+    }
+
+    struct Scanner {
+        const DFA& dfa;
+        int state;
+        void reset() { state = dfa.start_state; }
+        bool step(unsigned char c) { return (state = dfa.next_state(state, c)) >= 0; }
+        bool accepting() const { return dfa.is_accepting(state); }
+        bool live(const ReverseLiveness& liveness, std::int32_t id) const { return liveness.contains(id, state); }
+    } scanner{*this, start_state};
+    return find_leftmost_longest(text, liveness, scanner);
 }
 
 // ------------------ DFA Basic DOT Export ------------------
@@ -79,49 +194,37 @@ std::string DFA::toDotWithInput(const std::string &input) const {
     ss << "  start -> q" << start_state << ";\n\n";
 
     // Record visited states and used transitions while simulating the input
-    std::unordered_set<std::string> used_edges;
-    std::unordered_set<int> visited_states;
-    std::vector<int> path_states;
+    compile();
+    std::set<std::pair<int, char>> used_edges;   // (from state, symbol)
+    std::vector<bool> in_path(states.size(), false);
 
     int current = start_state;
     if (current >= 0 && current < static_cast<int>(states.size())) {
-        visited_states.insert(current);
-        path_states.push_back(current);
+        in_path[current] = true;
     }
 
     for (char c : input) {
         if (current < 0 || current >= static_cast<int>(states.size())) 
             break;
         
-        const auto &trans = states[current].transitions;
-        auto it = trans.find(c);
-        if (it == trans.end()) {
+        int next = next_state(current, static_cast<unsigned char>(c));
+        if (next < 0) {
             // No transition - input rejected
             break;
         }
         
-        int next = it->second;
-        std::string key = std::to_string(current) + "->" + 
-                         std::to_string(next) + ":" + 
-                         std::string(1, c);
-        used_edges.insert(key);
+        // Bytes without an explicit edge were taken on the wildcard edge
+        const auto& trans = states[current].transitions;
+        used_edges.insert({current, trans.count(c) ? c : NFA::WILDCARD});
         current = next;
-        visited_states.insert(current);
-        path_states.push_back(current);
+        in_path[current] = true;
     }
 
     // Draw all states with highlighting
     for (const DFAState &s : states) {
         ss << "  q" << s.id;
         
-        bool visited = (visited_states.count(s.id) > 0);
-        bool is_in_path = false;
-        for (size_t i = 0; i < path_states.size(); i++) {
-            if (path_states[i] == s.id) {
-                is_in_path = true;
-                break;
-            }
-        }
+        bool is_in_path = in_path[s.id];
         
         if (s.is_final && is_in_path) {
             ss << " [peripheries=2, style=filled, fillcolor=orange]";
@@ -129,8 +232,6 @@ std::string DFA::toDotWithInput(const std::string &input) const {
             ss << " [peripheries=2]";
         } else if (is_in_path) {
             ss << " [style=filled, fillcolor=yellow]";
-        } else if (visited) {
-            ss << " [style=filled, fillcolor=lightblue]";
         }
         ss << ";\n";
     }
@@ -141,9 +242,6 @@ std::string DFA::toDotWithInput(const std::string &input) const {
         for (const auto &p : s.transitions) {
             char symbol = p.first;
             int to = p.second;
-            std::string key = std::to_string(s.id) + "->" + 
-                             std::to_string(to) + ":" + 
-                             std::string(1, symbol);
 
             ss << "  q" << s.id << " -> q" << to << " [label=\"";
             
@@ -157,7 +255,7 @@ std::string DFA::toDotWithInput(const std::string &input) const {
             
             ss << "\"";
             
-            if (used_edges.count(key)) {
+            if (used_edges.count({s.id, symbol})) {
                 ss << ", color=red, penwidth=2";
             }
             ss << "];\n";
@@ -192,8 +290,6 @@ bool DFA::is_dead_state(int state_id) const {
 
 DFA convert_nfa_to_dfa(const NFA& nfa) {
     DFA dfa;
-    std::unordered_map<std::string, int> state_map;
-    std::queue<std::unordered_set<int>> q;
     int next_id = 0;
     
     // Define alphabet based on NFA transitions
@@ -222,97 +318,146 @@ DFA convert_nfa_to_dfa(const NFA& nfa) {
         alphabet.insert(' ');
     }
     
-    // Helper: convert a set of NFA states into a unique string key
-    auto closure_to_key = [](const std::unordered_set<int>& s) {
-        if (s.empty()) return std::string("DEAD");
-        std::vector<int> v(s.begin(), s.end());
-        std::sort(v.begin(), v.end());
-        std::string key;
-        for (int x : v) key += std::to_string(x) + ",";
-        return key;
+    // Subset states are sorted vectors of NFA states, stored back to back in
+    // `sets` (one slice per DFA state, in id order, so BFS order is id order)
+    // and found again through a hash of their contents.
+    const int nfa_count = static_cast<int>(nfa_nodes.size());
+    std::vector<int> sets;
+    std::vector<size_t> set_begin{0};
+    std::unordered_multimap<std::uint64_t, int> state_map;
+
+    auto hash_set = [](const std::vector<int>& set) {
+        std::uint64_t h = 0x9E3779B97F4A7C15ULL;
+        for (int x : set) {
+            h ^= static_cast<std::uint64_t>(x) + 0x9E3779B97F4A7C15ULL + (h << 6) + (h >> 2);
+        }
+        return h;
+    };
+
+    auto find_or_add = [&](const std::vector<int>& set) {
+        std::uint64_t h = hash_set(set);
+        auto range = state_map.equal_range(h);
+        for (auto it = range.first; it != range.second; ++it) {
+            size_t b = set_begin[it->second], e = set_begin[it->second + 1];
+            if (e - b == set.size() && std::equal(set.begin(), set.end(), sets.begin() + b)) {
+                return it->second;
+            }
+        }
+        DFAState ns;
+        ns.id = next_id++;
+        ns.is_final = false;
+        for (int x : set) {
+            if (nfa.get_final_states().count(x)) { ns.is_final = true; break; }
+        }
+        dfa.get_states().push_back(ns);
+        sets.insert(sets.end(), set.begin(), set.end());
+        set_begin.push_back(sets.size());
+        state_map.emplace(h, ns.id);
+        return ns.id;
+    };
+
+    // Epsilon closures are computed once per NFA state, on first use. They
+    // keep only states with symbol transitions or acceptance: pure epsilon
+    // states cannot change where a subset goes next, and dropping them keeps
+    // the long epsilon chains of big alternations out of every key.
+    std::vector<std::vector<int>> closure_of(nfa_count);
+    std::vector<bool> closure_done(nfa_count, false);
+    std::vector<int> visited(nfa_count, -1);
+    std::vector<int> stack;
+    auto closure = [&](int s) -> const std::vector<int>& {
+        if (closure_done[s]) return closure_of[s];
+        std::vector<int>& out = closure_of[s];
+        visited[s] = s;
+        stack.assign(1, s);
+        while (!stack.empty()) {
+            int q = stack.back();
+            stack.pop_back();
+            if (!nfa_nodes[q]->transitions.empty() || nfa.get_final_states().count(q)) {
+                out.push_back(q);
+            }
+            for (int t : nfa_nodes[q]->epsilon_transitions) {
+                if (visited[t] != s) {
+                    visited[t] = s;
+                    stack.push_back(t);
+                }
+            }
+        }
+        closure_done[s] = true;
+        return out;
     };
 
     // Start state: epsilon-closure of NFA start state
-    std::unordered_set<int> start_set = nfa.epsilon_closure({ nfa.get_start_state() });
-    std::string start_key = closure_to_key(start_set);
-    state_map[start_key] = next_id;
-
-    DFAState start_dfa_state;
-    start_dfa_state.id = next_id++;
-    start_dfa_state.is_final = false;
-    for (int f : nfa.get_final_states())
-        if (start_set.count(f)) start_dfa_state.is_final = true;
-    dfa.get_states().push_back(start_dfa_state);
+    std::vector<int> start_set = closure(nfa.get_start_state());
+    std::sort(start_set.begin(), start_set.end());
+    find_or_add(start_set);
     dfa.set_start_state(0);
 
-    if (!start_set.empty()) {
-        q.push(start_set);
+    // Per DFA state, NFA targets are bucketed by symbol in one pass over the
+    // member states; wildcard targets join every symbol's bucket.
+    std::array<int, 256> symbol_index;
+    symbol_index.fill(-1);
+    std::vector<char> symbols(alphabet.begin(), alphabet.end());
+    for (size_t i = 0; i < symbols.size(); i++) {
+        symbol_index[static_cast<unsigned char>(symbols[i])] = static_cast<int>(i);
     }
+    std::vector<std::vector<int>> buckets(symbols.size());
+    std::vector<int> wildcard_targets, next_set;
+    std::vector<int> stamp(nfa_count, 0);
+    int generation = 0;
 
-    while (!q.empty()) {
-        auto current_set = q.front(); 
-        q.pop();
-        std::string current_key = closure_to_key(current_set);
-        int current_id = state_map[current_key];
-
-        // Collect all wildcard destinations for this DFA state
-        std::unordered_set<int> wildcard_dests;
-        for (int nfa_state : current_set) {
-            const auto& node = nfa_nodes[nfa_state];
-            auto it_wild = node->transitions.find(NFA::WILDCARD);
-            if (it_wild != node->transitions.end()) {
-                for (int t : it_wild->second) {
-                    wildcard_dests.insert(t);
+    for (int current_id = 0; current_id < next_id; current_id++) {
+        for (auto& bucket : buckets) bucket.clear();
+        wildcard_targets.clear();
+        for (size_t i = set_begin[current_id]; i < set_begin[current_id + 1]; i++) {
+            for (const auto& trans : nfa_nodes[sets[i]]->transitions) {
+                std::vector<int>* bucket = &wildcard_targets;
+                if (trans.first != NFA::WILDCARD) {
+                    int idx = symbol_index[static_cast<unsigned char>(trans.first)];
+                    if (idx < 0) continue;
+                    bucket = &buckets[idx];
                 }
+                bucket->insert(bucket->end(), trans.second.begin(), trans.second.end());
             }
         }
-        // Take epsilon-closure of wildcard destinations
-        std::unordered_set<int> wildcard_closures = nfa.epsilon_closure(wildcard_dests);
 
-        // For each character in alphabet, compute transition
-        for (char symbol : alphabet) {
-            std::unordered_set<int> next_set_raw = wildcard_closures; // Start with wildcard closures
-            
-            // Get all NFA states reachable on this exact symbol from current_set
-            for (int nfa_state : current_set) {
-                const auto& node = nfa_nodes[nfa_state];
-                
-                // Check for exact match
-                auto it = node->transitions.find(symbol);
-                if (it != node->transitions.end()) {
-                    for (int t : it->second) {
-                        next_set_raw.insert(t);
+        for (size_t i = 0; i < symbols.size(); i++) {
+            if (buckets[i].empty() && wildcard_targets.empty()) {
+                continue; // Will be filled with dead state later
+            }
+            generation++;
+            next_set.clear();
+            for (const std::vector<int>* bucket : { &buckets[i], &wildcard_targets }) {
+                for (int t : *bucket) {
+                    if (stamp[t] == generation) continue;
+                    for (int x : closure(t)) {
+                        if (stamp[x] != generation) {
+                            stamp[x] = generation;
+                            next_set.push_back(x);
+                        }
                     }
                 }
             }
-            
-            // Take epsilon-closure of combined destinations
-            std::unordered_set<int> next_set = nfa.epsilon_closure(next_set_raw);
-            std::string next_key = closure_to_key(next_set);
-            
-            // Skip if this leads to dead state (we'll handle dead state later)
-            if (next_set.empty()) {
-                continue; // Will be filled with dead state later
-            }
-            
-            int next_id_local;
-            if (!state_map.count(next_key)) {
-                next_id_local = next_id++;
-                state_map[next_key] = next_id_local;
-
-                DFAState ns;
-                ns.id = next_id_local;
-                ns.is_final = false;
-                for (int f : nfa.get_final_states())
-                    if (next_set.count(f)) ns.is_final = true;
-
-                dfa.get_states().push_back(ns);
-                q.push(next_set);
-            } else {
-                next_id_local = state_map[next_key];
+            std::sort(next_set.begin(), next_set.end());
+            int target = find_or_add(next_set);
+            dfa.get_states()[current_id].transitions[symbols[i]] = target;
+        }
+
+        // Bytes outside the alphabet follow only the wildcard targets; this
+        // becomes the state's default (WILDCARD-keyed) transition
+        if (!wildcard_targets.empty()) {
+            generation++;
+            next_set.clear();
+            for (int t : wildcard_targets) {
+                for (int x : closure(t)) {
+                    if (stamp[x] != generation) {
+                        stamp[x] = generation;
+                        next_set.push_back(x);
+                    }
+                }
             }
-            
-            dfa.get_states()[current_id].transitions[symbol] = next_id_local;
+            std::sort(next_set.begin(), next_set.end());
+            int target = find_or_add(next_set);
+            dfa.get_states()[current_id].transitions[NFA::WILDCARD] = target;
         }
     }
     
@@ -347,13 +492,233 @@ DFA convert_nfa_to_dfa(const NFA& nfa) {
         for (auto& state : dfa.get_states()) {
             if (state.id == dead_id) continue; // Skip dead state itself
             
+            state.transitions.reserve(alphabet.size());
             for (char c : alphabet) {
-                if (state.transitions.find(c) == state.transitions.end()) {
-                    state.transitions[c] = dead_id;
-                }
+                state.transitions.try_emplace(c, dead_id);
             }
         }
     }
     
     return dfa;
-}
\ No newline at end of file
+}
+// ------------------ Lexicon DFA ------------------
+
+DFA build_lexicon_dfa(const std::vector<std::string>& words) {
+    DFA dfa;
+    int root = dfa.add_state();
+    dfa.set_start_state(root);
+
+    // Trie over the words; children are looked up in the map form, so
+    // building stays linear in the total word length
+    for (size_t id = 0; id < words.size(); id++) {
+        int state = root;
+        for (char c : words[id]) {
+            auto& transitions = dfa.get_states()[state].transitions;
+            auto it = transitions.find(c);
+            if (it != transitions.end()) {
+                state = it->second;
+            } else {
+                int next = dfa.add_state();
+                dfa.add_transition(state, c, next);
+                state = next;
+            }
+        }
+        dfa.add_output(state, static_cast<int>(id));
+    }
+
+    minimize(dfa);
+    return dfa;
+}
+
+// ------------------ DFA Minimization (Hopcroft) ------------------
+
+void minimize(DFA& dfa) {
+    const DFA& src = dfa;
+    src.compile();
+    const auto& old_states = src.get_states();
+    const int k = src.get_num_classes();
+    if (old_states.empty()) return;
+
+    // 1. Keep only states reachable from the start state. Missing transitions
+    //    go to an implicit sink, which gets the last dense index.
+    std::vector<int> dense(old_states.size(), -1);
+    std::vector<int> reachable;
+    dense[src.get_start_state()] = 0;
+    reachable.push_back(src.get_start_state());
+    for (size_t head = 0; head < reachable.size(); head++) {
+        int s = reachable[head];
+        for (int c = 0; c < k; c++) {
+            int to = src.next_state_by_class(s, c);
+            if (to >= 0 && dense[to] < 0) {
+                dense[to] = static_cast<int>(reachable.size());
+                reachable.push_back(to);
+            }
+        }
+    }
+    const int sink = static_cast<int>(reachable.size());
+    const int n = sink + 1;
+
+    auto delta = [&](int s, int c) {
+        if (s == sink) return sink;
+        int to = src.next_state_by_class(reachable[s], c);
+        return to < 0 ? sink : dense[to];
+    };
+
+    // 2. Inverse transitions in CSR form: inv_targets[inv_offsets[t*k+c] ..]
+    //    lists the states that reach t on class c.
+    std::vector<int> inv_offsets(static_cast<size_t>(n) * k + 1, 0);
+    for (int s = 0; s < n; s++)
+        for (int c = 0; c < k; c++)
+            inv_offsets[static_cast<size_t>(delta(s, c)) * k + c + 1]++;
+    for (size_t i = 1; i < inv_offsets.size(); i++) inv_offsets[i] += inv_offsets[i - 1];
+    std::vector<int> inv_targets(inv_offsets.back());
+    {
+        std::vector<int> fill(inv_offsets.begin(), inv_offsets.end() - 1);
+        for (int s = 0; s < n; s++)
+            for (int c = 0; c < k; c++)
+                inv_targets[fill[static_cast<size_t>(delta(s, c)) * k + c]++] = s;
+    }
+
+    // 3. Initial partition: non-accepting states, then accepting states
+    //    grouped by their outputs. Blocks are contiguous ranges of `elems`;
+    //    pos[s] is the index of s inside `elems`.
+    std::vector<int> elems(n), pos(n), block_of(n);
+    std::vector<int> block_start, block_end, marked;
+    {
+        std::map<std::vector<int>, int> output_group;
+        std::vector<int> group(n, 0);
+        for (int s = 0; s < sink; s++) {
+            const DFAState& st = old_states[reachable[s]];
+            if (!st.is_final) continue;
+            group[s] = output_group.emplace(st.outputs, static_cast<int>(output_group.size()) + 1).first->second;
+        }
+
+        std::vector<int> group_start(output_group.size() + 2, 0);
+        for (int s = 0; s < n; s++) group_start[group[s] + 1]++;
+        for (size_t g = 1; g < group_start.size(); g++) group_start[g] += group_start[g - 1];
+        std::vector<int> fill(group_start.begin(), group_start.end() - 1);
+        for (int s = 0; s < n; s++) {
+            elems[fill[group[s]]] = s;
+            pos[s] = fill[group[s]]++;
+        }
+        for (size_t g = 0; g + 1 < group_start.size(); g++) {
+            if (group_start[g] == group_start[g + 1]) continue;
+            int b = static_cast<int>(block_start.size());
+            block_start.push_back(group_start[g]);
+            block_end.push_back(group_start[g + 1]);
+            marked.push_back(0);
+            for (int i = group_start[g]; i < group_start[g + 1]; i++) block_of[elems[i]] = b;
+        }
+    }
+
+    // 4. Refinement. The worklist holds (block, class) splitters.
+    std::vector<std::pair<int, int>> work;
+    std::vector<char> in_work;
+    auto push_work = [&](int b, int c) {
+        size_t key = static_cast<size_t>(b) * k + c;
+        if (in_work.size() <= key) in_work.resize((static_cast<size_t>(b) + 1) * k, 0);
+        if (!in_work[key]) {
+            in_work[key] = 1;
+            work.push_back({b, c});
+        }
+    };
+    for (int b = 0; b < static_cast<int>(block_start.size()); b++)
+        for (int c = 0; c < k; c++) push_work(b, c);
+
+    std::vector<int> preds, touched;
+    std::vector<int> seen(n, -1);
+    int round = 0;
+    while (!work.empty()) {
+        auto [splitter, c] = work.back();
+        work.pop_back();
+        in_work[static_cast<size_t>(splitter) * k + c] = 0;
+        round++;
+
+        // Collect predecessors of the splitter block on class c
+        preds.clear();
+        for (int i = block_start[splitter]; i < block_end[splitter]; i++) {
+            size_t key = static_cast<size_t>(elems[i]) * k + c;
+            for (int j = inv_offsets[key]; j < inv_offsets[key + 1]; j++) {
+                int p = inv_targets[j];
+                if (seen[p] != round) {
+                    seen[p] = round;
+                    preds.push_back(p);
+                }
+            }
+        }
+
+        // Move each predecessor to the marked prefix of its block
+        touched.clear();
+        for (int p : preds) {
+            int b = block_of[p];
+            if (marked[b] == 0) touched.push_back(b);
+            int dst = block_start[b] + marked[b]++;
+            int other = elems[dst];
+            std::swap(elems[dst], elems[pos[p]]);
+            pos[other] = pos[p];
+            pos[p] = dst;
+        }
+
+        // Split every block that was only partially marked
+        for (int b : touched) {
+            int m = marked[b];
+            marked[b] = 0;
+            if (m == block_end[b] - block_start[b]) continue;
+
+            int nb = static_cast<int>(block_start.size());
+            block_start.push_back(block_start[b]);
+            block_end.push_back(block_start[b] + m);
+            marked.push_back(0);
+            block_start[b] += m;
+            for (int i = block_start[nb]; i < block_end[nb]; i++) block_of[elems[i]] = nb;
+
+            int size_new = m;
+            int size_old = block_end[b] - block_start[b];
+            for (int a = 0; a < k; a++) {
+                size_t key = static_cast<size_t>(b) * k + a;
+                if (key < in_work.size() && in_work[key]) push_work(nb, a);
+                else push_work(size_new <= size_old ? nb : b, a);
+            }
+        }
+    }
+
+    // 5. Rebuild the DFA from the blocks, numbering them in BFS order from the
+    //    start block. A block holding only the implicit sink is not emitted.
+    auto representative = [&](int b) {
+        for (int i = block_start[b]; i < block_end[b]; i++)
+            if (elems[i] != sink) return elems[i];
+        return -1;
+    };
+
+    const int num_blocks = static_cast<int>(block_start.size());
+    std::vector<int> new_id(num_blocks, -1);
+    std::vector<int> order;
+    new_id[block_of[0]] = 0;
+    order.push_back(block_of[0]);
+    for (size_t head = 0; head < order.size(); head++) {
+        int rep = representative(order[head]);
+        for (const auto& p : old_states[reachable[rep]].transitions) {
+            int tb = block_of[dense[p.second]];
+            if (representative(tb) < 0 || new_id[tb] >= 0) continue;
+            new_id[tb] = static_cast<int>(order.size());
+            order.push_back(tb);
+        }
+    }
+
+    DFA result;
+    for (int b : order) {
+        const DFAState& rep_state = old_states[reachable[representative(b)]];
+        int id = result.add_state(rep_state.is_final);
+        for (int pattern_id : rep_state.outputs) result.add_output(id, pattern_id);
+    }
+    for (int b : order) {
+        int rep = representative(b);
+        for (const auto& p : old_states[reachable[rep]].transitions) {
+            int tb = block_of[dense[p.second]];
+            if (new_id[tb] >= 0) result.add_transition(new_id[b], p.first, new_id[tb]);
+        }
+    }
+    result.set_start_state(0);
+    result.compile();
+    dfa = std::move(result);
+}
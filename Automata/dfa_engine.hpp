@@ -2,32 +2,91 @@
 #define DFA_ENGINE_HPP
 
 #include "nfa_engine.hpp"
+#include "span_search.hpp"
 #include <vector>
 #include <unordered_map>
 #include <string>
+#include <string_view>
+#include <array>
+#include <atomic>
+#include <cstdint>
+#include <mutex>
 #include <set>  // ADD THIS LINE
+#include <algorithm>
 
 // DFA State structure
 struct DFAState {
     int id;
     bool is_final;
     std::unordered_map<char, int> transitions; // char -> next state id
-    
+    std::vector<int> outputs;                  // pattern ids accepted here, sorted
 };
 
 // DFA class
+//
+// The DFA is built through the map form in DFAState (add_state/add_transition,
+// convert_nfa_to_dfa). Matching runs on a compiled form: one contiguous table
+// indexed by state * num_classes + byte_class, where byte_class folds the 256
+// input bytes into equivalence classes (bytes with identical columns share a
+// class). The compiled form is rebuilt lazily whenever the map form changes.
+// The lazy builds are locked, so a DFA that is no longer being modified can
+// be matched from several threads at once.
+//
+// Final states may carry pattern ids (outputs) naming which of several
+// patterns they accept, as in a lexicon built by build_lexicon_dfa().
 class DFA {
 private:
     std::vector<DFAState> states;
     int start_state;
 
+    // Compiled representation (see compile()). -1 in the table means
+    // "no transition", i.e. the input is rejected.
+    mutable int num_classes = 0;
+    mutable std::array<std::uint8_t, 256> byte_class{};
+    mutable std::vector<std::int32_t> table;
+    mutable std::vector<std::uint8_t> accepting;
+    mutable std::vector<std::uint32_t> output_begin;  // CSR: state s outputs output_ids[output_begin[s] ..
+    mutable std::vector<std::uint32_t> output_ids;    //      output_begin[s + 1])
+
+    // Reverse liveness for find_all(), over the states of this DFA. Built
+    // on first use.
+    mutable ReverseLiveness liveness;
+
+    // Which lazy builds are current. They are made under the mutex and
+    // published with release stores, so const methods may race to build.
+    // A copy gets its own mutex and the source's flags.
+    struct BuildState {
+        std::mutex mutex;
+        std::atomic<bool> compiled{false};
+        std::atomic<bool> liveness_built{false};
+
+        BuildState() = default;
+        BuildState(const BuildState& other)
+            : compiled(other.compiled.load()), liveness_built(other.liveness_built.load()) {}
+        BuildState& operator=(const BuildState& other) {
+            compiled = other.compiled.load();
+            liveness_built = other.liveness_built.load();
+            return *this;
+        }
+    };
+    mutable BuildState build;
+
+    // The map form changed: both lazy builds are stale
+    void invalidate() {
+        build.compiled.store(false, std::memory_order_relaxed);
+        build.liveness_built.store(false, std::memory_order_relaxed);
+    }
+    void build_table() const;
+    void build_liveness() const;
+
 public:
     DFA() : start_state(0) {}
     
     // Add a new state and return its ID
     int add_state(bool is_final = false) {
         int id = static_cast<int>(states.size());
-        states.push_back({id, is_final, {}});
+        states.push_back({id, is_final, {}, {}});
+        invalidate();
         return id;
     }
     
@@ -35,6 +94,7 @@ public:
     void add_transition(int from, char symbol, int to) {
         if (from >= 0 && from < static_cast<int>(states.size())) {
             states[from].transitions[symbol] = to;
+            invalidate();
         }
     }
     
@@ -49,18 +109,57 @@ public:
     void set_final_state(int state_id, bool final = true) {
         if (state_id >= 0 && state_id < static_cast<int>(states.size())) {
             states[state_id].is_final = final;
+            invalidate();
         }
     }
     
-    // Get states (for conversion)
-    std::vector<DFAState>& get_states() { return states; }
+    // Tag a state as accepting pattern `pattern_id` (also makes it final)
+    void add_output(int state_id, int pattern_id) {
+        if (state_id >= 0 && state_id < static_cast<int>(states.size()) && pattern_id >= 0) {
+            std::vector<int>& outputs = states[state_id].outputs;
+            auto it = std::lower_bound(outputs.begin(), outputs.end(), pattern_id);
+            if (it == outputs.end() || *it != pattern_id) outputs.insert(it, pattern_id);
+            states[state_id].is_final = true;
+            invalidate();
+        }
+    }
+    
+    // Get states (for conversion). Mutable access invalidates the compiled table.
+    std::vector<DFAState>& get_states() { invalidate(); return states; }
     const std::vector<DFAState>& get_states() const { return states; }
     
     // Get start state
     int get_start_state() const { return start_state; }
     
+    // Build the dense transition table and byte-class map from the map form,
+    // unless they are current. Safe to call from several threads.
+    void compile() const;
+    
+    // Compiled-table accessors (compile() must have run)
+    int get_num_classes() const { return num_classes; }
+    const std::array<std::uint8_t, 256>& get_byte_classes() const { return byte_class; }
+    int next_state(int state, unsigned char c) const {
+        return table[static_cast<size_t>(state) * num_classes + byte_class[c]];
+    }
+    int next_state_by_class(int state, int cls) const {
+        return table[static_cast<size_t>(state) * num_classes + cls];
+    }
+    bool is_accepting(int state) const { return accepting[state] != 0; }
+    template <typename F>
+    void for_each_output(int state, F&& f) const {
+        for (std::uint32_t i = output_begin[state]; i < output_begin[state + 1]; i++) f(static_cast<int>(output_ids[i]));
+    }
+    const std::vector<std::int32_t>& get_table() const { return table; }
+    const std::vector<std::uint8_t>& get_accepting() const { return accepting; }
+    const std::vector<std::uint32_t>& get_output_begin() const { return output_begin; }
+    const std::vector<std::uint32_t>& get_output_ids() const { return output_ids; }
+    
     // Simulation
-    bool simulate(const std::string& input);
+    bool simulate(std::string_view input) const;
+    
+    // Unanchored search: leftmost-longest, non-overlapping, non-empty match
+    // spans [start, end), in time linear in the text (see span_search.hpp)
+    std::vector<std::pair<int, int>> find_all(std::string_view text) const;
     
     // DOT export
     std::string toDot() const;
@@ -73,4 +172,14 @@ public:
 // Conversion function
 DFA convert_nfa_to_dfa(const NFA& nfa);
 
+// Whole-string matcher for a word list: state outputs name the words
+// accepted (word i gets pattern id i). Built as a trie, then minimized.
+// Words must not contain the NFA::WILDCARD byte.
+DFA build_lexicon_dfa(const std::vector<std::string>& words);
+
+// Minimization (Hopcroft partition refinement). Drops unreachable states and
+// merges equivalent ones in place; missing transitions are treated as going to
+// an implicit non-accepting sink. States with different outputs stay apart.
+void minimize(DFA& dfa);
+
 #endif // DFA_ENGINE_HPP
\ No newline at end of file
@@ -0,0 +1,182 @@
+#include "dfa_serialization.hpp"
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <vector>
+
+namespace {
+    constexpr std::uint64_t SECTION_ALIGNMENT = 8;
+
+    std::uint64_t align_up(std::uint64_t offset) {
+        return (offset + SECTION_ALIGNMENT - 1) & ~(SECTION_ALIGNMENT - 1);
+    }
+
+    // Whether count elements of elem_size bytes fit in the file at offset
+    bool section_fits(std::uint64_t offset, std::uint64_t count, std::uint64_t elem_size, std::uint64_t file_size) {
+        return offset % SECTION_ALIGNMENT == 0 && offset <= file_size &&
+               count <= (file_size - offset) / elem_size;
+    }
+}
+
+// ==================== WRITER ====================
+
+bool save_compiled_dfa(const DFA& dfa, const std::string& path) {
+    dfa.compile();
+    const auto& table = dfa.get_table();
+    const auto& accepting = dfa.get_accepting();
+    const auto& output_begin = dfa.get_output_begin();
+    const auto& output_ids = dfa.get_output_ids();
+    const std::uint64_t n = accepting.size();
+    if (n > static_cast<std::uint64_t>(INT32_MAX) - 1) return false;
+
+    DFAFileHeader header{};
+    std::memcpy(header.magic, DFAFileHeader::MAGIC, sizeof(header.magic));
+    header.version = DFAFileHeader::VERSION;
+    header.byte_order = DFAFileHeader::ENDIAN_MARK;
+    header.num_states = static_cast<std::uint32_t>(n);
+    header.num_classes = static_cast<std::uint32_t>(dfa.get_num_classes());
+    header.start_state = n == 0 ? -1 : dfa.get_start_state();
+    header.num_outputs = static_cast<std::uint32_t>(output_ids.size());
+
+    header.byte_class_offset = align_up(sizeof(DFAFileHeader));
+    header.table_offset = align_up(header.byte_class_offset + 256);
+    header.accepting_offset = align_up(header.table_offset + table.size() * sizeof(std::int32_t));
+    header.output_begin_offset = align_up(header.accepting_offset + n);
+    header.output_ids_offset = align_up(header.output_begin_offset + (n + 1) * sizeof(std::uint32_t));
+    header.file_size = header.output_ids_offset + output_ids.size() * sizeof(std::uint32_t);
+
+    // Write beside the target, then rename over it: a reader that still
+    // maps the old file keeps the old inode
+    const std::string temp_path = path + ".tmp";
+    {
+        std::ofstream out(temp_path, std::ios::binary | std::ios::trunc);
+        if (!out) return false;
+
+        std::uint64_t written = 0;
+        auto write_at = [&](std::uint64_t offset, const void* data, std::uint64_t size) {
+            static const char zeros[SECTION_ALIGNMENT] = {};
+            out.write(zeros, static_cast<std::streamsize>(offset - written));
+            out.write(static_cast<const char*>(data), static_cast<std::streamsize>(size));
+            written = offset + size;
+        };
+        write_at(0, &header, sizeof(header));
+        write_at(header.byte_class_offset, dfa.get_byte_classes().data(), 256);
+        write_at(header.table_offset, table.data(), table.size() * sizeof(std::int32_t));
+        write_at(header.accepting_offset, accepting.data(), n);
+        write_at(header.output_begin_offset, output_begin.data(), (n + 1) * sizeof(std::uint32_t));
+        write_at(header.output_ids_offset, output_ids.data(), output_ids.size() * sizeof(std::uint32_t));
+
+        out.flush();
+        if (!out) {
+            out.close();
+            std::filesystem::remove(temp_path);
+            return false;
+        }
+    }
+
+    std::error_code ec;
+    std::filesystem::rename(temp_path, path, ec);
+    if (ec) {
+        std::filesystem::remove(temp_path, ec);
+        return false;
+    }
+    return true;
+}
+
+// ==================== READER ====================
+
+MappedDFA::MappedDFA(const std::string& path) : file(path, MappedFile::Access::Random) {
+    if (!file.is_mapped()) {
+        fail("cannot map " + path);
+        return;
+    }
+
+    std::string_view bytes = file.view();
+    if (bytes.size() < sizeof(DFAFileHeader)) {
+        fail("file too short for a header");
+        return;
+    }
+    header = reinterpret_cast<const DFAFileHeader*>(bytes.data());
+    if (std::memcmp(header->magic, DFAFileHeader::MAGIC, sizeof(header->magic)) != 0) {
+        fail("not a compiled DFA file");
+        return;
+    }
+    if (header->version != DFAFileHeader::VERSION) {
+        fail("unsupported format version " + std::to_string(header->version));
+        return;
+    }
+    if (header->byte_order != DFAFileHeader::ENDIAN_MARK) {
+        fail("file was written with a different byte order");
+        return;
+    }
+    if (header->file_size != bytes.size()) {
+        fail("file size does not match its header");
+        return;
+    }
+
+    const std::uint64_t size = bytes.size();
+    const std::uint64_t n = header->num_states;
+    const std::uint64_t k = header->num_classes;
+    if (k == 0 || k > 256 || n > static_cast<std::uint64_t>(INT32_MAX) - 1 ||
+        header->start_state < -1 || header->start_state >= static_cast<std::int64_t>(n) ||
+        (n > 0) != (header->start_state >= 0)) {
+        fail("invalid automaton dimensions");
+        return;
+    }
+    if (!section_fits(header->byte_class_offset, 256, 1, size) ||
+        !section_fits(header->table_offset, n * k, sizeof(std::int32_t), size) ||
+        !section_fits(header->accepting_offset, n, 1, size) ||
+        !section_fits(header->output_begin_offset, n + 1, sizeof(std::uint32_t), size) ||
+        !section_fits(header->output_ids_offset, header->num_outputs, sizeof(std::uint32_t), size)) {
+        fail("section out of bounds");
+        return;
+    }
+
+    byte_class = reinterpret_cast<const std::uint8_t*>(bytes.data() + header->byte_class_offset);
+    table = reinterpret_cast<const std::int32_t*>(bytes.data() + header->table_offset);
+    accepting = reinterpret_cast<const std::uint8_t*>(bytes.data() + header->accepting_offset);
+    output_begin = reinterpret_cast<const std::uint32_t*>(bytes.data() + header->output_begin_offset);
+    output_ids = reinterpret_cast<const std::uint32_t*>(bytes.data() + header->output_ids_offset);
+
+    // The byte-class map is one page at most; check it here so next_state()
+    // never indexes outside a row
+    for (int c = 0; c < 256; c++) {
+        if (byte_class[c] >= k) {
+            fail("byte class out of range");
+            return;
+        }
+    }
+    loaded = true;
+}
+
+bool MappedDFA::fail(const std::string& message) {
+    load_error = message;
+    loaded = false;
+    header = nullptr;
+    return false;
+}
+
+bool MappedDFA::verify() const {
+    if (!loaded) return false;
+    const std::uint64_t n = header->num_states;
+    const std::uint64_t k = header->num_classes;
+    for (std::uint64_t i = 0; i < n * k; i++) {
+        if (table[i] < -1 || table[i] >= static_cast<std::int64_t>(n)) return false;
+    }
+    if (output_begin[0] != 0 || output_begin[n] != header->num_outputs) return false;
+    for (std::uint64_t s = 0; s < n; s++) {
+        if (output_begin[s] > output_begin[s + 1]) return false;
+    }
+    return true;
+}
+
+bool MappedDFA::simulate(std::string_view input) const {
+    if (!loaded || header->start_state < 0) return false;
+
+    int current = header->start_state;
+    for (char c : input) {
+        current = next_state(current, static_cast<unsigned char>(c));
+        if (current < 0) return false;
+    }
+    return is_accepting(current);
+}
@@ -0,0 +1,122 @@
+#ifndef DFA_SERIALIZATION_HPP
+#define DFA_SERIALIZATION_HPP
+
+#include "dfa_engine.hpp"
+#include "mapped_file.hpp"
+#include <cstdint>
+#include <string>
+#include <string_view>
+
+/**
+ * @file dfa_serialization.hpp
+ * @brief Binary file format for compiled DFAs, and a zero-copy reader
+ *
+ * A file holds a DFA's compiled form as written by save_compiled_dfa(), so
+ * a large automaton (e.g. a lexicon from build_lexicon_dfa()) is built once
+ * and then loaded by mapping the file instead of rebuilding it from
+ * pattern text. Layout, in native byte order, every section starting at a
+ * multiple of 8 bytes:
+ *
+ *   DFAFileHeader
+ *   byte_class     uint8[256]
+ *   table          int32[num_states * num_classes]   (-1 = no transition)
+ *   accepting      uint8[num_states]
+ *   output_begin   uint32[num_states + 1]
+ *   output_ids     uint32[num_outputs]
+ *
+ * Readers reject files with another magic, version or byte order.
+ */
+
+/**
+ * @struct DFAFileHeader
+ * @brief Fixed-size header at offset 0 of a compiled DFA file
+ */
+struct DFAFileHeader {
+    static constexpr char MAGIC[8] = {'A', 'U', 'T', 'O', 'D', 'F', 'A', '\0'};
+    static constexpr std::uint32_t VERSION = 1;
+    static constexpr std::uint32_t ENDIAN_MARK = 0x01020304;
+
+    char magic[8];
+    std::uint32_t version;
+    std::uint32_t byte_order;      ///< ENDIAN_MARK as written by the producer
+    std::uint32_t num_states;
+    std::uint32_t num_classes;
+    std::int32_t start_state;      ///< -1 for an empty DFA
+    std::uint32_t num_outputs;
+    std::uint64_t file_size;
+    std::uint64_t byte_class_offset;
+    std::uint64_t table_offset;
+    std::uint64_t accepting_offset;
+    std::uint64_t output_begin_offset;
+    std::uint64_t output_ids_offset;
+};
+
+/**
+ * @brief Write a DFA's compiled form to a file
+ *
+ * Writes to a temporary file next to path and renames it into place, so
+ * processes that have the old file mapped keep a consistent view.
+ *
+ * @return false if the file could not be written
+ */
+bool save_compiled_dfa(const DFA& dfa, const std::string& path);
+
+/**
+ * @class MappedDFA
+ * @brief Read-only DFA served straight from a mapped compiled DFA file
+ *
+ * Loading maps the file and checks the header: the cost does not depend on
+ * the automaton's size, and pages are read on first touch. The mapping is
+ * shared, so worker processes loading the same file share one copy in the
+ * page cache, and threads can share one MappedDFA. Accessors mirror DFA's
+ * compiled-table interface.
+ *
+ * Only the header and section bounds are checked on load; call verify()
+ * before using a file from an untrusted source.
+ */
+class MappedDFA {
+public:
+    explicit MappedDFA(const std::string& path);
+
+    bool is_loaded() const { return loaded; }
+    const std::string& error() const { return load_error; }
+
+    /**
+     * @brief Check every table entry and output range (reads the whole file)
+     */
+    bool verify() const;
+
+    int get_start_state() const { return header->start_state; }
+    int get_num_states() const { return static_cast<int>(header->num_states); }
+    int get_num_classes() const { return static_cast<int>(header->num_classes); }
+    int next_state(int state, unsigned char c) const {
+        return table[static_cast<size_t>(state) * header->num_classes + byte_class[c]];
+    }
+    bool is_accepting(int state) const { return accepting[state] != 0; }
+
+    template <typename F>
+    void for_each_output(int state, F&& f) const {
+        for (std::uint32_t i = output_begin[state]; i < output_begin[state + 1]; i++) f(static_cast<int>(output_ids[i]));
+    }
+
+    /**
+     * @brief Whole-string match, as DFA::simulate()
+     */
+    bool simulate(std::string_view input) const;
+
+private:
+    MappedFile file;
+    bool loaded = false;
+    std::string load_error;
+
+    const DFAFileHeader* header = nullptr;
+    const std::uint8_t* byte_class = nullptr;
+    const std::int32_t* table = nullptr;
+    const std::uint8_t* accepting = nullptr;
+    const std::uint32_t* output_begin = nullptr;
+    const std::uint32_t* output_ids = nullptr;
+
+    bool fail(const std::string& message);
+};
+
+#endif // DFA_SERIALIZATION_HPP
@@ -0,0 +1,111 @@
+#include "edit_distance.hpp"
+#include "cpu_features.hpp"
+#include <cctype>
+
+#if HAVE_X86_SIMD
+#include <immintrin.h>
+#endif
+
+// ==================== PATTERN PREPARATION ====================
+
+MyersPattern::MyersPattern(std::string_view pattern)
+    : length(static_cast<int>(pattern.size())) {
+    for (int i = 0; i < length; i++) {
+        unsigned char c = static_cast<unsigned char>(pattern[i]);
+        peq[std::tolower(c)] |= 1ULL << i;
+        peq[std::toupper(c)] |= 1ULL << i;
+    }
+    last_bit = length > 0 ? 1ULL << (length - 1) : 0;
+}
+
+// ==================== SCALAR KERNEL ====================
+
+int myers_distance(const MyersPattern& pattern, std::string_view text) {
+    if (pattern.length == 0) return static_cast<int>(text.size());
+
+    // Pv/Mv: +1/-1 vertical deltas of the current column. The first column
+    // is 0..m, so every delta starts at +1.
+    std::uint64_t pv = ~0ULL;
+    std::uint64_t mv = 0;
+    int score = pattern.length;
+    for (char ch : text) {
+        std::uint64_t eq = pattern.peq[static_cast<unsigned char>(ch)];
+        std::uint64_t xv = eq | mv;
+        std::uint64_t xh = (((eq & pv) + pv) ^ pv) | eq;
+        std::uint64_t ph = mv | ~(xh | pv);
+        std::uint64_t mh = pv & xh;
+        if (ph & pattern.last_bit) score++;
+        else if (mh & pattern.last_bit) score--;
+        // Global distance: the top row is 0..n, so a +1 shifts in at row 0
+        ph = (ph << 1) | 1;
+        mh <<= 1;
+        pv = mh | ~(xv | ph);
+        mv = ph & xv;
+    }
+    return score;
+}
+
+// ==================== AVX2 KERNEL ====================
+
+#if HAVE_X86_SIMD
+// Same recurrence as myers_distance, one pattern per 64-bit lane
+TARGET_AVX2
+static void myers_distance_x4_avx2(const MyersPattern* const* p, std::string_view text, int* out) {
+    const __m256i ones = _mm256_set1_epi64x(-1);
+    const __m256i one = _mm256_set1_epi64x(1);
+    const __m256i last = _mm256_set_epi64x(
+        static_cast<long long>(p[3]->last_bit), static_cast<long long>(p[2]->last_bit),
+        static_cast<long long>(p[1]->last_bit), static_cast<long long>(p[0]->last_bit));
+    __m256i pv = ones;
+    __m256i mv = _mm256_setzero_si256();
+    __m256i score = _mm256_set_epi64x(p[3]->length, p[2]->length, p[1]->length, p[0]->length);
+
+    for (char ch : text) {
+        unsigned char c = static_cast<unsigned char>(ch);
+        __m256i eq = _mm256_set_epi64x(
+            static_cast<long long>(p[3]->peq[c]), static_cast<long long>(p[2]->peq[c]),
+            static_cast<long long>(p[1]->peq[c]), static_cast<long long>(p[0]->peq[c]));
+        __m256i xv = _mm256_or_si256(eq, mv);
+        __m256i sum = _mm256_add_epi64(_mm256_and_si256(eq, pv), pv);
+        __m256i xh = _mm256_or_si256(_mm256_xor_si256(sum, pv), eq);
+        __m256i ph = _mm256_or_si256(mv, _mm256_andnot_si256(_mm256_or_si256(xh, pv), ones));
+        __m256i mh = _mm256_and_si256(pv, xh);
+
+        // Lane compares give -1 where the last bit is set: score += [ph] - [mh]
+        __m256i ph_last = _mm256_cmpeq_epi64(_mm256_and_si256(ph, last), last);
+        __m256i mh_last = _mm256_cmpeq_epi64(_mm256_and_si256(mh, last), last);
+        score = _mm256_add_epi64(_mm256_sub_epi64(score, ph_last), mh_last);
+
+        ph = _mm256_or_si256(_mm256_slli_epi64(ph, 1), one);
+        mh = _mm256_slli_epi64(mh, 1);
+        pv = _mm256_or_si256(mh, _mm256_andnot_si256(_mm256_or_si256(xv, ph), ones));
+        mv = _mm256_and_si256(ph, xv);
+    }
+
+    alignas(32) long long lanes[4];
+    _mm256_store_si256(reinterpret_cast<__m256i*>(lanes), score);
+    for (int i = 0; i < 4; i++) out[i] = static_cast<int>(lanes[i]);
+}
+#endif
+
+// ==================== DISPATCH ====================
+
+void myers_distance_batch(const MyersPattern* const* patterns, size_t count,
+                          std::string_view text, int* distances) {
+    size_t i = 0;
+#if HAVE_X86_SIMD
+    if (cpu_has_avx2()) {
+        for (; i + 4 <= count; i += 4) {
+            myers_distance_x4_avx2(patterns + i, text, distances + i);
+        }
+    }
+#endif
+    for (; i < count; i++) {
+        distances[i] = myers_distance(*patterns[i], text);
+    }
+
+    // An empty pattern has no last bit to track; its distance is |text|
+    for (size_t j = 0; j < count; j++) {
+        if (patterns[j]->length == 0) distances[j] = static_cast<int>(text.size());
+    }
+}
@@ -0,0 +1,51 @@
+#ifndef EDIT_DISTANCE_HPP
+#define EDIT_DISTANCE_HPP
+
+#include <array>
+#include <string_view>
+#include <cstdint>
+#include <cstddef>
+
+/**
+ * @struct MyersPattern
+ * @brief Precomputed match masks of one pattern for bit-parallel edit distance
+ *
+ * peq[c] has bit i set when pattern[i] equals byte c, ignoring ASCII case,
+ * so case folding costs nothing while scanning.
+ */
+struct MyersPattern {
+    static constexpr size_t MAX_LENGTH = 64;  ///< One machine word per column
+
+    std::array<std::uint64_t, 256> peq{};
+    std::uint64_t last_bit = 0;  ///< Bit of the last pattern position
+    int length = 0;
+
+    /**
+     * @param pattern Pattern of at most MAX_LENGTH bytes
+     */
+    explicit MyersPattern(std::string_view pattern);
+};
+
+/**
+ * @brief Levenshtein distance between text and a pattern (Myers/Hyyrö)
+ *
+ * Computes one DP column per text byte as bit vectors of vertical deltas,
+ * in O(|text|) word operations instead of the O(|text| * |pattern|) matrix.
+ */
+int myers_distance(const MyersPattern& pattern, std::string_view text);
+
+/**
+ * @brief Distances from one text to several patterns
+ *
+ * Patterns are scored four at a time in the 64-bit lanes of an AVX2
+ * register when the CPU supports it, otherwise one by one.
+ *
+ * @param patterns Array of count patterns
+ * @param count Number of patterns
+ * @param text Text to score
+ * @param distances Output array of count distances
+ */
+void myers_distance_batch(const MyersPattern* const* patterns, size_t count,
+                          std::string_view text, int* distances);
+
+#endif // EDIT_DISTANCE_HPP
@@ -0,0 +1,165 @@
+#include "lazy_dfa.hpp"
+#include <algorithm>
+
+// ==================== CONSTRUCTION ====================
+
+LazyDFA::LazyDFA(const NFA& source, size_t max_cache_bytes)
+    : nfa(source) {
+    const size_t words = nfa.words();
+    const size_t classes = static_cast<size_t>(nfa.get_num_classes());
+
+    // Approximate footprint of one cached state (set, row, flag, index entry)
+    size_t per_state = words * sizeof(std::uint64_t) + classes * sizeof(std::int32_t) + 1 + 32;
+    max_states = std::max<size_t>(max_cache_bytes / per_state, 4);
+
+    scratch.resize(words);
+    saved.resize(words);
+    reset(anchored, nfa.start_set());
+    reset(reverse, nfa.final_set());
+}
+
+void LazyDFA::reset(Cache& cache, const std::uint64_t* start) {
+    cache.sets.clear();
+    cache.next.clear();
+    cache.accepting.clear();
+    cache.index.clear();
+    cache.start = intern(cache, start);
+}
+
+// ==================== STATE CACHE ====================
+
+std::uint64_t LazyDFA::hash_set(const std::uint64_t* set) const {
+    std::uint64_t h = 0x9E3779B97F4A7C15ULL;
+    for (size_t w = 0; w < nfa.words(); w++) {
+        h ^= set[w] + 0x9E3779B97F4A7C15ULL + (h << 6) + (h >> 2);
+    }
+    return h;
+}
+
+std::int32_t LazyDFA::intern(Cache& cache, const std::uint64_t* set) {
+    const size_t words = nfa.words();
+    std::uint64_t h = hash_set(set);
+    auto range = cache.index.equal_range(h);
+    for (auto it = range.first; it != range.second; ++it) {
+        const std::uint64_t* existing = &cache.sets[static_cast<size_t>(it->second) * words];
+        if (std::equal(set, set + words, existing)) return it->second;
+    }
+
+    std::int32_t id = static_cast<std::int32_t>(cache.size());
+    cache.sets.insert(cache.sets.end(), set, set + words);
+    cache.next.insert(cache.next.end(), nfa.get_num_classes(), UNKNOWN);
+    cache.accepting.push_back(nfa.any_final(set) ? 1 : 0);
+    cache.index.emplace(h, id);
+    return id;
+}
+
+std::int32_t LazyDFA::transition(Cache& cache, std::int32_t state, int cls) {
+    const size_t words = nfa.words();
+    const size_t classes = static_cast<size_t>(nfa.get_num_classes());
+
+    nfa.step(&cache.sets[static_cast<size_t>(state) * words], cls, scratch.data());
+    if (nfa.is_empty(scratch.data())) {
+        cache.next[static_cast<size_t>(state) * classes + cls] = DEAD;
+        return DEAD;
+    }
+
+    if (cache.size() + 1 >= max_states) {
+        // Out of budget: clear and restart from the current set
+        std::copy_n(&cache.sets[static_cast<size_t>(state) * words], words, saved.begin());
+        reset(cache, nfa.start_set());
+        cache.clears++;
+        state = intern(cache, saved.data());
+        std::int32_t to = intern(cache, scratch.data());
+        cache.next[static_cast<size_t>(state) * classes + cls] = to;
+        return to;
+    }
+
+    std::int32_t to = intern(cache, scratch.data());
+    cache.next[static_cast<size_t>(state) * classes + cls] = to;
+    return to;
+}
+
+std::int32_t LazyDFA::reverse_transition(std::int32_t state, int cls) {
+    const size_t words = nfa.words();
+    const size_t classes = static_cast<size_t>(nfa.get_num_classes());
+
+    // Positions already labelled hold ids of this cache, so it cannot be
+    // cleared halfway through a text like the forward one
+    if (reverse.size() + 1 >= max_states) return FULL;
+
+    nfa.step_back(&reverse.sets[static_cast<size_t>(state) * words], cls, scratch.data());
+    std::int32_t to = intern(reverse, scratch.data());
+    reverse.next[static_cast<size_t>(state) * classes + cls] = to;
+    return to;
+}
+
+bool LazyDFA::label_liveness(std::string_view text, std::vector<std::int32_t>& at) {
+    const size_t classes = static_cast<size_t>(nfa.get_num_classes());
+    at.resize(text.size() + 1);
+    std::int32_t state = reverse.start;
+    at[text.size()] = state;
+    for (size_t p = text.size(); p-- > 0;) {
+        int cls = nfa.class_of(static_cast<unsigned char>(text[p]));
+        std::int32_t to = reverse.next[static_cast<size_t>(state) * classes + cls];
+        if (to == UNKNOWN) to = reverse_transition(state, cls);
+        if (to == FULL) {
+            // The rest stays unlabelled, i.e. live; the next text starts
+            // from an empty cache
+            std::fill(at.begin(), at.begin() + p + 1, UNKNOWN);
+            reset(reverse, nfa.final_set());
+            reverse.clears++;
+            break;
+        }
+        state = to;
+        at[p] = state;
+    }
+    return true;
+}
+
+// ==================== MATCHING ====================
+
+bool LazyDFA::simulate(std::string_view input) {
+    const size_t classes = static_cast<size_t>(nfa.get_num_classes());
+    std::int32_t state = anchored.start;
+    for (char c : input) {
+        int cls = nfa.class_of(static_cast<unsigned char>(c));
+        std::int32_t to = anchored.next[static_cast<size_t>(state) * classes + cls];
+        if (to == UNKNOWN) to = transition(anchored, state, cls);
+        if (to == DEAD) return false;
+        state = to;
+    }
+    return anchored.accepting[state] != 0;
+}
+
+std::vector<std::pair<int, int>> LazyDFA::find_all(std::string_view text) {
+    struct Liveness {
+        LazyDFA& lazy;
+        bool scan(std::string_view text, std::vector<std::int32_t>& at) const { return lazy.label_liveness(text, at); }
+    } liveness{*this};
+    struct Scanner {
+        LazyDFA& lazy;
+        std::int32_t state;
+        void reset() { state = lazy.anchored.start; }
+        bool step(unsigned char c) {
+            const size_t classes = static_cast<size_t>(lazy.nfa.get_num_classes());
+            int cls = lazy.nfa.class_of(c);
+            std::int32_t to = lazy.anchored.next[static_cast<size_t>(state) * classes + cls];
+            if (to == UNKNOWN) to = lazy.transition(lazy.anchored, state, cls);
+            if (to == DEAD) return false;
+            state = to;
+            return true;
+        }
+        bool accepting() const { return lazy.anchored.accepting[state] != 0; }
+        bool live(const Liveness&, std::int32_t id) const {
+            if (id == UNKNOWN) return true;
+            const size_t words = lazy.nfa.words();
+            const std::uint64_t* current = &lazy.anchored.sets[static_cast<size_t>(state) * words];
+            const std::uint64_t* rest = &lazy.reverse.sets[static_cast<size_t>(id) * words];
+            for (size_t w = 0; w < words; w++) {
+                if (current[w] & rest[w]) return true;
+            }
+            return false;
+        }
+    } scanner{*this, anchored.start};
+    return find_leftmost_longest(text, liveness, scanner);
+}
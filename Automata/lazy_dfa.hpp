@@ -0,0 +1,73 @@
+#ifndef LAZY_DFA_HPP
+#define LAZY_DFA_HPP
+
+#include "nfa_engine.hpp"
+#include <vector>
+#include <string_view>
+#include <unordered_map>
+#include <cstdint>
+
+/**
+ * @class LazyDFA
+ * @brief On-demand DFA over an NFA (RE2/Hyperscan style)
+ *
+ * Sits between NFA and DFA: construction only compiles the NFA to its
+ * bit-parallel form, so it is instant. DFA states (sets of NFA states) are
+ * created the first time a (state, byte class) transition is taken while
+ * scanning, and cached in a dense next-state table. The cache is bounded by
+ * a memory budget; when it fills up it is cleared and scanning restarts from
+ * the current set, so memory stays fixed while steady-state speed is that of
+ * a table-driven DFA.
+ *
+ * find_all() labels the text with liveness (see span_search.hpp) from a
+ * second cache of reverse states, built the same way one step at a time
+ * and under the same budget, so searching has no up-front cost either.
+ */
+class LazyDFA {
+public:
+    explicit LazyDFA(const NFA& nfa, size_t max_cache_bytes = DEFAULT_CACHE_BYTES);
+
+    static constexpr size_t DEFAULT_CACHE_BYTES = 8u << 20;
+
+    bool simulate(std::string_view input);
+
+    // Leftmost-longest, non-overlapping, non-empty match spans [start, end),
+    // in time linear in the text (see span_search.hpp)
+    std::vector<std::pair<int, int>> find_all(std::string_view text);
+
+    // Cache statistics
+    size_t cached_states() const { return anchored.size(); }
+    size_t cache_clears() const { return anchored.clears; }
+
+private:
+    static constexpr std::int32_t UNKNOWN = -2;
+    static constexpr std::int32_t DEAD = -1;
+    static constexpr std::int32_t FULL = -3;
+
+    // One cache of DFA states
+    struct Cache {
+        std::vector<std::uint64_t> sets;        // state i: words [i*W, (i+1)*W)
+        std::vector<std::int32_t> next;         // state i: row [i*C, (i+1)*C)
+        std::vector<std::uint8_t> accepting;
+        std::unordered_multimap<std::uint64_t, std::int32_t> index;  // set hash -> state
+        std::int32_t start = 0;
+        size_t clears = 0;
+        size_t size() const { return accepting.size(); }
+    };
+
+    BitParallelNFA nfa;
+    size_t max_states;
+    Cache anchored;
+    Cache reverse;  // Liveness: start is the final set, steps go backwards
+    std::vector<std::uint64_t> scratch;
+    std::vector<std::uint64_t> saved;
+
+    void reset(Cache& cache, const std::uint64_t* start);
+    std::int32_t intern(Cache& cache, const std::uint64_t* set);
+    std::int32_t transition(Cache& cache, std::int32_t state, int cls);
+    std::int32_t reverse_transition(std::int32_t state, int cls);
+    bool label_liveness(std::string_view text, std::vector<std::int32_t>& at);
+    std::uint64_t hash_set(const std::uint64_t* set) const;
+};
+
+#endif // LAZY_DFA_HPP
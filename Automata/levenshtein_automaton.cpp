@@ -0,0 +1,74 @@
+#include "levenshtein_automaton.hpp"
+#include <algorithm>
+#include <cctype>
+
+// ==================== CONSTRUCTION ====================
+
+LevenshteinAutomaton::LevenshteinAutomaton(const std::string& pattern, int k)
+    : max_edits(std::clamp(k, 0, MAX_EDITS)), row_size(pattern.size() + 1) {
+    // One class per distinct (lowercased) pattern byte, class 0 for the rest.
+    // Uppercase letters share their lowercase class.
+    byte_class.fill(0);
+    num_classes = 1;
+    for (char ch : pattern) {
+        unsigned char c = static_cast<unsigned char>(std::tolower(static_cast<unsigned char>(ch)));
+        if (byte_class[c] == 0) byte_class[c] = static_cast<std::uint16_t>(num_classes++);
+        pattern_class.push_back(byte_class[c]);
+    }
+    for (int c = 'A'; c <= 'Z'; c++) byte_class[c] = byte_class[std::tolower(c)];
+
+    // Start row: reaching position j costs j deletions
+    std::string start(row_size, 0);
+    for (size_t j = 0; j < row_size; j++) {
+        start[j] = static_cast<char>(std::min<size_t>(j, max_edits + 1));
+    }
+    intern(start);
+}
+
+std::int32_t LevenshteinAutomaton::intern(const std::string& row) {
+    auto it = index.find(row);
+    if (it != index.end()) return it->second;
+
+    std::int32_t id = static_cast<std::int32_t>(state_count());
+    rows.insert(rows.end(), row.begin(), row.end());
+    table.insert(table.end(), num_classes, UNKNOWN);
+    index.emplace(row, id);
+    return id;
+}
+
+// ==================== MATCHING ====================
+
+int LevenshteinAutomaton::step(int state, unsigned char c) {
+    if (state == DEAD) return DEAD;
+    const int cls = byte_class[c];
+    const size_t slot = static_cast<size_t>(state) * num_classes + cls;
+    if (table[slot] != UNKNOWN) return table[slot];
+
+    // One DP row update: insertion (up), deletion (left), match/substitution
+    // (diagonal), all clipped at k+1
+    const int limit = max_edits + 1;
+    const std::uint8_t* row = &rows[static_cast<size_t>(state) * row_size];
+    scratch.assign(row_size, 0);
+    scratch[0] = static_cast<char>(std::min(row[0] + 1, limit));
+    bool alive = scratch[0] <= max_edits;
+    for (size_t j = 1; j < row_size; j++) {
+        int cost = (cls != 0 && pattern_class[j - 1] == cls) ? 0 : 1;
+        int v = std::min({ row[j] + 1, scratch[j - 1] + 1, row[j - 1] + cost, limit });
+        scratch[j] = static_cast<char>(v);
+        alive = alive || v <= max_edits;
+    }
+
+    std::int32_t next = alive ? intern(scratch) : DEAD;
+    table[slot] = next;  // intern may have grown the table, so index again
+    return next;
+}
+
+int LevenshteinAutomaton::match(std::string_view word) {
+    int state = start_state();
+    for (char ch : word) {
+        state = step(state, static_cast<unsigned char>(ch));
+        if (state == DEAD) return -1;
+    }
+    int d = distance(state);
+    return d <= max_edits ? d : -1;
+}
@@ -0,0 +1,78 @@
+#ifndef LEVENSHTEIN_AUTOMATON_HPP
+#define LEVENSHTEIN_AUTOMATON_HPP
+
+#include <vector>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <array>
+#include <cstdint>
+
+/**
+ * @class LevenshteinAutomaton
+ * @brief DFA accepting every word within k edits of a pattern
+ *
+ * This is the executable form of the (pos, edits) machine drawn by
+ * ApproximateMatcher::toDotRegexFSM. A DFA state is the set of active
+ * (pos, edits) states, stored as a DP row clipped at k+1: row[pos] is the
+ * fewest edits that reach pattern position pos. Clipping keeps the number
+ * of distinct rows finite, so the rows can be interned as DFA states.
+ *
+ * States and transitions are built on demand the first time they are
+ * needed and cached in a dense (state x byte class) table. Later words then
+ * cost one table lookup per character. Matching is ASCII
+ * case-insensitive, like ApproximateMatcher::levenshtein_distance.
+ */
+class LevenshteinAutomaton {
+public:
+    static constexpr int MAX_EDITS = 3;  ///< Largest supported k
+    static constexpr int DEAD = -1;      ///< No extension of the input can match
+
+    /**
+     * @brief Compile the automaton for a pattern
+     * @param pattern Pattern to match against (taken literally)
+     * @param max_edits Edit budget k, 0..MAX_EDITS
+     */
+    LevenshteinAutomaton(const std::string& pattern, int max_edits);
+
+    int start_state() const { return 0; }
+
+    /**
+     * @brief Transition on one input byte, building the target if needed
+     * @return Next state, or DEAD
+     */
+    int step(int state, unsigned char c);
+
+    /**
+     * @brief Edit distance between the consumed input and the pattern
+     * @return Distance if at most k, otherwise k+1
+     */
+    int distance(int state) const {
+        return state == DEAD ? max_edits + 1 : rows[static_cast<size_t>(state) * row_size + row_size - 1];
+    }
+
+    /**
+     * @brief Edit distance between a whole word and the pattern
+     * @return Distance if at most k, otherwise -1
+     */
+    int match(std::string_view word);
+
+    size_t state_count() const { return rows.size() / row_size; }
+
+private:
+    static constexpr std::int32_t UNKNOWN = -2;
+
+    int max_edits;
+    size_t row_size;                          // pattern length + 1
+    int num_classes;
+    std::array<std::uint16_t, 256> byte_class; // 0 = byte not in pattern
+    std::vector<std::uint16_t> pattern_class; // class of each pattern byte
+    std::vector<std::uint8_t> rows;           // state i: row [i*row_size, (i+1)*row_size)
+    std::vector<std::int32_t> table;          // (state * num_classes + cls) -> state
+    std::unordered_map<std::string, std::int32_t> index;  // row bytes -> state
+    std::string scratch;
+
+    std::int32_t intern(const std::string& row);
+};
+
+#endif // LEVENSHTEIN_AUTOMATON_HPP
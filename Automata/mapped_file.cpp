@@ -0,0 +1,158 @@
+#include "mapped_file.hpp"
+#include <algorithm>
+#include <cstring>
+#include <cstdint>
+#include <utility>
+
+#ifdef _WIN32
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+// ==================== MAPPED FILE ====================
+
+MappedFile::MappedFile(const std::string& path, Access access) {
+#ifdef _WIN32
+    DWORD hint = access == Access::Random ? FILE_FLAG_RANDOM_ACCESS : FILE_FLAG_SEQUENTIAL_SCAN;
+    HANDLE file = CreateFileA(path.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr,
+                              OPEN_EXISTING, hint, nullptr);
+    if (file == INVALID_HANDLE_VALUE) return;
+
+    LARGE_INTEGER file_size;
+    if (GetFileType(file) == FILE_TYPE_DISK && GetFileSizeEx(file, &file_size) &&
+        static_cast<unsigned long long>(file_size.QuadPart) <= SIZE_MAX) {
+        if (file_size.QuadPart == 0) {
+            mapped = true;  // nothing to map, but still a regular file
+        } else {
+            HANDLE mapping = CreateFileMappingA(file, nullptr, PAGE_READONLY, 0, 0, nullptr);
+            if (mapping) {
+                void* view = MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0);
+                if (view) {
+                    data = static_cast<const char*>(view);
+                    length = static_cast<size_t>(file_size.QuadPart);
+                    mapping_handle = mapping;
+                    mapped = true;
+                } else {
+                    CloseHandle(mapping);
+                }
+            }
+        }
+    }
+    CloseHandle(file);  // the mapping keeps the file open
+#else
+    int fd = ::open(path.c_str(), O_RDONLY | O_CLOEXEC);
+    if (fd < 0) return;
+
+    struct stat st;
+    if (::fstat(fd, &st) == 0 && S_ISREG(st.st_mode) &&
+        static_cast<unsigned long long>(st.st_size) <= SIZE_MAX) {
+        if (st.st_size == 0) {
+            mapped = true;  // mmap rejects zero length
+        } else {
+            size_t file_size = static_cast<size_t>(st.st_size);
+            void* view = ::mmap(nullptr, file_size, PROT_READ, MAP_PRIVATE, fd, 0);
+            if (view != MAP_FAILED) {
+                ::madvise(view, file_size, access == Access::Random ? MADV_RANDOM : MADV_SEQUENTIAL);
+                data = static_cast<const char*>(view);
+                length = file_size;
+                mapped = true;
+            }
+        }
+    }
+    ::close(fd);  // the mapping keeps the file open
+#endif
+}
+
+MappedFile::~MappedFile() {
+    release();
+}
+
+MappedFile::MappedFile(MappedFile&& other) noexcept {
+    *this = std::move(other);
+}
+
+MappedFile& MappedFile::operator=(MappedFile&& other) noexcept {
+    if (this != &other) {
+        release();
+        data = std::exchange(other.data, nullptr);
+        length = std::exchange(other.length, 0);
+        mapped = std::exchange(other.mapped, false);
+#ifdef _WIN32
+        mapping_handle = std::exchange(other.mapping_handle, nullptr);
+#endif
+    }
+    return *this;
+}
+
+void MappedFile::release() {
+#ifdef _WIN32
+    if (data) UnmapViewOfFile(data);
+    if (mapping_handle) CloseHandle(mapping_handle);
+    mapping_handle = nullptr;
+#else
+    if (data) ::munmap(const_cast<char*>(data), length);
+#endif
+    data = nullptr;
+    length = 0;
+    mapped = false;
+}
+
+// ==================== LINE SOURCE ====================
+
+LineSource::LineSource(const std::string& path) : mapping(path) {
+    if (!mapping.is_mapped()) {
+        // Pipe, FIFO or mapping failure: buffered reads
+        stream.open(path, std::ios::binary);
+        buffer.resize(READ_BUFFER_BYTES);
+    }
+}
+
+bool LineSource::next(std::string_view& line) {
+    if (mapping.is_mapped()) {
+        std::string_view all = mapping.view();
+        if (position >= all.size()) return false;
+
+        size_t newline = all.find('\n', position);
+        if (newline == std::string_view::npos) newline = all.size();
+        line = all.substr(position, newline - position);
+        position = newline + 1;
+    } else {
+        if (!stream.is_open()) return false;
+
+        const char* newline;
+        while (!(newline = static_cast<const char*>(
+                     std::memchr(buffer.data() + begin, '\n', end - begin)))) {
+            if (!refill()) {
+                // Last line without a trailing newline
+                if (begin == end) return false;
+                newline = buffer.data() + end;
+                break;
+            }
+        }
+        line = std::string_view(buffer.data() + begin, static_cast<size_t>(newline - (buffer.data() + begin)));
+        begin = std::min(end, begin + line.size() + 1);
+    }
+
+    // Accept CRLF files the same way text-mode streams do on Windows
+    if (!line.empty() && line.back() == '\r') line.remove_suffix(1);
+    return true;
+}
+
+bool LineSource::refill() {
+    // Keep the partial line, and grow only if it fills the whole buffer
+    if (begin > 0) {
+        std::memmove(buffer.data(), buffer.data() + begin, end - begin);
+        end -= begin;
+        begin = 0;
+    }
+    if (end == buffer.size()) buffer.resize(buffer.size() * 2);
+
+    stream.read(buffer.data() + end, static_cast<std::streamsize>(buffer.size() - end));
+    size_t got = static_cast<size_t>(stream.gcount());
+    end += got;
+    return got > 0;
+}
@@ -0,0 +1,90 @@
+#ifndef MAPPED_FILE_HPP
+#define MAPPED_FILE_HPP
+
+#include <string>
+#include <string_view>
+#include <fstream>
+#include <vector>
+
+/**
+ * @class MappedFile
+ * @brief Read-only memory mapping of a whole file
+ *
+ * Maps regular files with mmap (MapViewOfFile on Windows) and advises the
+ * kernel how the pages will be read (sequentially unless told otherwise).
+ * Pipes, FIFOs and character
+ * devices cannot be mapped; for them is_mapped() is false and callers fall
+ * back to buffered reads. Move-only; the view is valid for the object's
+ * lifetime.
+ */
+class MappedFile {
+public:
+    enum class Access { Sequential, Random };
+
+    MappedFile() = default;
+    explicit MappedFile(const std::string& path, Access access = Access::Sequential);
+    ~MappedFile();
+
+    MappedFile(MappedFile&& other) noexcept;
+    MappedFile& operator=(MappedFile&& other) noexcept;
+    MappedFile(const MappedFile&) = delete;
+    MappedFile& operator=(const MappedFile&) = delete;
+
+    /**
+     * @brief Whether the file is mapped (an empty regular file counts)
+     */
+    bool is_mapped() const { return mapped; }
+
+    std::string_view view() const { return std::string_view(data, length); }
+    size_t size() const { return length; }
+
+private:
+    const char* data = nullptr;
+    size_t length = 0;
+    bool mapped = false;
+#ifdef _WIN32
+    void* mapping_handle = nullptr;
+#endif
+
+    void release();
+};
+
+/**
+ * @class LineSource
+ * @brief Line-by-line reader handing out string_view slices
+ *
+ * Uses a MappedFile when the input can be mapped, so lines are views into
+ * the mapping and nothing is copied. Otherwise reads through a fixed
+ * buffer that only grows for lines longer than it. Lines are split on '\n'
+ * like std::getline, with a trailing '\r' dropped so CRLF logs read the
+ * same on every platform. A line view stays valid until the next call
+ * to next() (for mapped input, until the LineSource is destroyed).
+ */
+class LineSource {
+public:
+    static constexpr size_t READ_BUFFER_BYTES = 64u << 10;
+
+    explicit LineSource(const std::string& path);
+
+    bool is_open() const { return mapping.is_mapped() || stream.is_open(); }
+    bool is_mapped() const { return mapping.is_mapped(); }
+
+    /**
+     * @brief Fetch the next line (without its '\n')
+     * @return false at end of input
+     */
+    bool next(std::string_view& line);
+
+private:
+    MappedFile mapping;
+    size_t position = 0;  // next unread byte of the mapping
+
+    std::ifstream stream;
+    std::vector<char> buffer;
+    size_t begin = 0;     // unconsumed bytes are buffer[begin, end)
+    size_t end = 0;
+
+    bool refill();
+};
+
+#endif // MAPPED_FILE_HPP
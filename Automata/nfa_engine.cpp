@@ -6,6 +6,8 @@
 
 #include <stack>
 #include <iomanip>
+#include <algorithm>
+#include <bit>
 
 // -------------------- NFA core impl --------------------
 
@@ -354,6 +356,42 @@ std::string RegexToNFA::to_postfix(const std::string& infix) {
     return out;
 }
 
+bool RegexToNFA::is_supported(const std::string& regex) {
+    int depth = 0;
+    bool can_repeat = false;    // last token was an atom or ')'
+    bool empty_branch = true;   // nothing yet since start, '(' or '|'
+    for (char c : regex) {
+        switch (c) {
+            case '(':
+                depth++;
+                can_repeat = false;
+                empty_branch = true;
+                break;
+            case ')':
+                if (depth == 0 || empty_branch) return false;
+                depth--;
+                can_repeat = true;
+                break;
+            case '|':
+                if (empty_branch) return false;
+                can_repeat = false;
+                empty_branch = true;
+                break;
+            case '*': case '+': case '?':
+                if (!can_repeat) return false;
+                can_repeat = false;
+                break;
+            case '\\': case '^': case '$': case '[': case ']': case '{': case '}':
+            case CONCAT: case NFA::WILDCARD:
+                return false;
+            default:
+                can_repeat = true;
+                empty_branch = false;
+        }
+    }
+    return depth == 0 && (regex.empty() || !empty_branch);
+}
+
 NFA RegexToNFA::from_regex(const std::string& regex) {
     // small edge: empty regex -> NFA that accepts empty string
     if (regex.empty()) {
@@ -472,3 +510,237 @@ NFA RegexToNFA::build_from_postfix(const std::string& postfix) {
     return nfa;
 }
 
+
+// -------------------- Bit-parallel compiled NFA --------------------
+
+BitParallelNFA::BitParallelNFA(const NFA& nfa) {
+    const auto& nodes = nfa.get_nodes();
+    num_states = static_cast<int>(nodes.size());
+    num_words = (static_cast<size_t>(num_states) + 63) / 64;
+    if (num_words == 0) num_words = 1;
+
+    // Byte classes: one per explicit symbol, class 0 for every other byte.
+    // Wildcard edges apply to all classes.
+    byte_class.fill(0);
+    num_classes = 1;
+    for (const auto& node : nodes) {
+        for (const auto& kv : node->transitions) {
+            unsigned char sym = static_cast<unsigned char>(kv.first);
+            if (kv.first == NFA::WILDCARD || byte_class[sym] != 0) continue;
+            byte_class[sym] = static_cast<std::uint8_t>(num_classes++);
+        }
+    }
+
+    // CSR transition layout: one contiguous target range per (state, class)
+    offsets.assign(static_cast<size_t>(num_states) * num_classes + 1, 0);
+    class_sources.assign(static_cast<size_t>(num_classes) * num_words, 0);
+    for (int s = 0; s < num_states; s++) {
+        const auto& trans = nodes[s]->transitions;
+        auto wild = trans.find(NFA::WILDCARD);
+        for (int c = 0; c < num_classes; c++) {
+            size_t slot = static_cast<size_t>(s) * num_classes + c;
+            offsets[slot] = static_cast<std::uint32_t>(targets.size());
+            if (c != 0) {
+                for (const auto& kv : trans) {
+                    if (kv.first != NFA::WILDCARD &&
+                        byte_class[static_cast<unsigned char>(kv.first)] == c) {
+                        for (int t : kv.second) targets.push_back(static_cast<std::uint32_t>(t));
+                    }
+                }
+            }
+            if (wild != trans.end()) {
+                for (int t : wild->second) targets.push_back(static_cast<std::uint32_t>(t));
+            }
+            if (targets.size() > offsets[slot]) {
+                class_sources[static_cast<size_t>(c) * num_words + s / 64] |= 1ULL << (s % 64);
+            }
+        }
+    }
+    offsets.back() = static_cast<std::uint32_t>(targets.size());
+
+    // Epsilon closures by depth-first search. Closures of lower-numbered
+    // states are already complete, so reaching one ORs its whole row in
+    // instead of walking below it.
+    closures.assign(static_cast<size_t>(num_states) * num_words, 0);
+    std::vector<int> stack;
+    for (int s = 0; s < num_states; s++) {
+        std::uint64_t* closure = &closures[static_cast<size_t>(s) * num_words];
+        closure[s / 64] |= 1ULL << (s % 64);
+        stack.assign(1, s);
+        while (!stack.empty()) {
+            int q = stack.back();
+            stack.pop_back();
+            for (int t : nodes[q]->epsilon_transitions) {
+                if (closure[t / 64] & (1ULL << (t % 64))) continue;
+                if (t < s) {
+                    const std::uint64_t* done = &closures[static_cast<size_t>(t) * num_words];
+                    for (size_t w = 0; w < num_words; w++) closure[w] |= done[w];
+                } else {
+                    closure[t / 64] |= 1ULL << (t % 64);
+                    stack.push_back(t);
+                }
+            }
+        }
+    }
+
+    final_mask.assign(num_words, 0);
+    for (int f : nfa.get_final_states()) final_mask[f / 64] |= 1ULL << (f % 64);
+
+    start_closure.assign(num_words, 0);
+    int start = nfa.get_start_state();
+    if (start >= 0 && start < num_states) {
+        const std::uint64_t* sc = &closures[static_cast<size_t>(start) * num_words];
+        std::copy(sc, sc + num_words, start_closure.begin());
+    }
+
+    // Reversed edges for step_back(), in CSR form: sources per (target,
+    // class), and epsilon sources per target
+    back_offsets.assign(static_cast<size_t>(num_states) * num_classes + 1, 0);
+    for (int s = 0; s < num_states; s++) {
+        for (int c = 0; c < num_classes; c++) {
+            size_t slot = static_cast<size_t>(s) * num_classes + c;
+            for (std::uint32_t i = offsets[slot]; i < offsets[slot + 1]; i++) {
+                back_offsets[static_cast<size_t>(targets[i]) * num_classes + c + 1]++;
+            }
+        }
+    }
+    for (size_t i = 1; i < back_offsets.size(); i++) back_offsets[i] += back_offsets[i - 1];
+    back_sources.resize(targets.size());
+    std::vector<std::uint32_t> fill(back_offsets.begin(), back_offsets.end() - 1);
+    for (int s = 0; s < num_states; s++) {
+        for (int c = 0; c < num_classes; c++) {
+            size_t slot = static_cast<size_t>(s) * num_classes + c;
+            for (std::uint32_t i = offsets[slot]; i < offsets[slot + 1]; i++) {
+                back_sources[fill[static_cast<size_t>(targets[i]) * num_classes + c]++] = static_cast<std::uint32_t>(s);
+            }
+        }
+    }
+
+    eps_back_offsets.assign(static_cast<size_t>(num_states) + 1, 0);
+    for (const auto& node : nodes) {
+        for (int t : node->epsilon_transitions) eps_back_offsets[t + 1]++;
+    }
+    for (size_t i = 1; i < eps_back_offsets.size(); i++) eps_back_offsets[i] += eps_back_offsets[i - 1];
+    eps_back_sources.resize(eps_back_offsets.back());
+    fill.assign(eps_back_offsets.begin(), eps_back_offsets.end() - 1);
+    for (int q = 0; q < num_states; q++) {
+        for (int t : nodes[q]->epsilon_transitions) eps_back_sources[fill[t]++] = static_cast<std::uint32_t>(q);
+    }
+}
+
+void BitParallelNFA::step(const std::uint64_t* current, int cls, std::uint64_t* next) const {
+    std::fill(next, next + num_words, 0);
+    const std::uint64_t* sources = &class_sources[static_cast<size_t>(cls) * num_words];
+    for (size_t w = 0; w < num_words; w++) {
+        std::uint64_t bits = current[w] & sources[w];
+        while (bits) {
+            size_t s = w * 64 + std::countr_zero(bits);
+            bits &= bits - 1;
+            size_t slot = s * num_classes + cls;
+            for (std::uint32_t i = offsets[slot]; i < offsets[slot + 1]; i++) {
+                std::uint32_t t = targets[i];
+                // A target already in the set brings nothing new: its closure
+                // is contained in the closure that added it.
+                if (next[t / 64] & (1ULL << (t % 64))) continue;
+                const std::uint64_t* closure = &closures[t * num_words];
+                for (size_t v = 0; v < num_words; v++) next[v] |= closure[v];
+            }
+        }
+    }
+}
+
+void BitParallelNFA::step_back(const std::uint64_t* live, int cls, std::uint64_t* prev) const {
+    // A state steps into live if one of its targets has a live state in its
+    // closure: walk epsilon edges backwards from the live states, and take
+    // the cls edges into every state reached
+    std::copy_n(final_mask.data(), num_words, prev);
+    std::vector<std::uint64_t> reached(live, live + num_words);
+    std::vector<std::uint32_t> stack;
+    for (size_t w = 0; w < num_words; w++) {
+        for (std::uint64_t bits = live[w]; bits; bits &= bits - 1) {
+            stack.push_back(static_cast<std::uint32_t>(w * 64 + std::countr_zero(bits)));
+        }
+    }
+    while (!stack.empty()) {
+        std::uint32_t y = stack.back();
+        stack.pop_back();
+        size_t slot = static_cast<size_t>(y) * num_classes + cls;
+        for (std::uint32_t i = back_offsets[slot]; i < back_offsets[slot + 1]; i++) {
+            prev[back_sources[i] / 64] |= 1ULL << (back_sources[i] % 64);
+        }
+        for (std::uint32_t i = eps_back_offsets[y]; i < eps_back_offsets[y + 1]; i++) {
+            std::uint32_t z = eps_back_sources[i];
+            if (reached[z / 64] & (1ULL << (z % 64))) continue;
+            reached[z / 64] |= 1ULL << (z % 64);
+            stack.push_back(z);
+        }
+    }
+}
+
+bool BitParallelNFA::any_final(const std::uint64_t* set) const {
+    for (size_t w = 0; w < num_words; w++) {
+        if (set[w] & final_mask[w]) return true;
+    }
+    return false;
+}
+
+bool BitParallelNFA::is_empty(const std::uint64_t* set) const {
+    for (size_t w = 0; w < num_words; w++) {
+        if (set[w]) return false;
+    }
+    return true;
+}
+
+bool BitParallelNFA::simulate(std::string_view input) const {
+    std::vector<std::uint64_t> cur(start_closure), next(num_words);
+    for (char c : input) {
+        step(cur.data(), byte_class[static_cast<unsigned char>(c)], next.data());
+        cur.swap(next);
+        if (is_empty(cur.data())) return false;
+    }
+    return any_final(cur.data());
+}
+
+const ReverseLiveness& BitParallelNFA::search_liveness() const {
+    if (liveness_state.built.load(std::memory_order_acquire)) return liveness;
+    std::lock_guard<std::mutex> lock(liveness_state.mutex);
+    if (liveness_state.built.load(std::memory_order_relaxed)) return liveness;
+
+    // Stepping from x on class c adds the closure of each target, so every
+    // state of those closures is a successor of x
+    std::vector<int> finals;
+    std::vector<ReverseLiveness::Edge> edges;
+    for (int x = 0; x < num_states; x++) {
+        if (final_mask[x / 64] & (1ULL << (x % 64))) finals.push_back(x);
+        for (int c = 0; c < num_classes; c++) {
+            size_t slot = static_cast<size_t>(x) * num_classes + c;
+            for (std::uint32_t i = offsets[slot]; i < offsets[slot + 1]; i++) {
+                const std::uint64_t* closure = &closures[targets[i] * num_words];
+                for (size_t w = 0; w < num_words; w++) {
+                    for (std::uint64_t bits = closure[w]; bits; bits &= bits - 1) {
+                        edges.push_back({x, c, static_cast<int>(w * 64 + std::countr_zero(bits))});
+                    }
+                }
+            }
+        }
+    }
+    liveness = ReverseLiveness(num_states, byte_class, num_classes, finals, edges);
+    liveness_state.built.store(true, std::memory_order_release);
+    return liveness;
+}
+
+std::vector<std::pair<int, int>> BitParallelNFA::find_all(std::string_view text) const {
+    struct Scanner {
+        const BitParallelNFA& nfa;
+        std::vector<std::uint64_t> cur, next;
+        void reset() { cur.assign(nfa.start_closure.begin(), nfa.start_closure.end()); }
+        bool step(unsigned char c) {
+            nfa.step(cur.data(), nfa.byte_class[c], next.data());
+            cur.swap(next);
+            return !nfa.is_empty(cur.data());
+        }
+        bool accepting() const { return nfa.any_final(cur.data()); }
+        bool live(const ReverseLiveness& liveness, std::int32_t id) const { return liveness.intersects(id, cur.data()); }
+    } scanner{*this, std::vector<std::uint64_t>(num_words), std::vector<std::uint64_t>(num_words)};
+    return find_leftmost_longest(text, search_liveness(), scanner);
+}
@@ -1,6 +1,7 @@
 #ifndef NFA_ENGINE_HPP
 #define NFA_ENGINE_HPP
 
+#include "span_search.hpp"
 #include <iostream>
 #include <vector>
 #include <string>
@@ -10,6 +11,11 @@
 #include <memory>
 #include <sstream>
 #include <utility>
+#include <string_view>
+#include <array>
+#include <cstdint>
+#include <atomic>
+#include <mutex>
 
 struct NFANode {
     int id;
@@ -78,6 +84,76 @@ public:
     std::string toDot() const;
 };
 
+// Compiled NFA for bit-parallel simulation.
+//
+// Transitions are flattened into CSR form (offsets + targets) keyed by
+// (state, byte class), and the epsilon closure of every state is precomputed
+// once as a bitset. A set of active states is a bitset of words() 64-bit
+// words; one input byte advances it by OR-ing the closures of the targets of
+// the active states, so simulation does no allocation per byte.
+class BitParallelNFA {
+public:
+    explicit BitParallelNFA(const NFA& nfa);
+
+    bool simulate(std::string_view input) const;
+
+    // Leftmost-longest, non-overlapping, non-empty match spans [start, end),
+    // in time linear in the text (see span_search.hpp)
+    std::vector<std::pair<int, int>> find_all(std::string_view text) const;
+
+    // Liveness of state sets for find_leftmost_longest(), built on first use.
+    // Safe to call from several threads.
+    const ReverseLiveness& search_liveness() const;
+
+    // Low-level stepping API (state sets are arrays of words() words)
+    int state_count() const { return num_states; }
+    size_t words() const { return num_words; }
+    int get_num_classes() const { return num_classes; }
+    int class_of(unsigned char c) const { return byte_class[c]; }
+    const std::array<std::uint8_t, 256>& get_byte_classes() const { return byte_class; }
+    const std::uint64_t* start_set() const { return start_closure.data(); }
+    const std::uint64_t* final_set() const { return final_mask.data(); }
+    void step(const std::uint64_t* current, int cls, std::uint64_t* next) const;
+    // One backward step of liveness (see ReverseLiveness): prev = the final
+    // states plus every state whose step on cls meets live
+    void step_back(const std::uint64_t* live, int cls, std::uint64_t* prev) const;
+    bool any_final(const std::uint64_t* set) const;
+    bool is_empty(const std::uint64_t* set) const;
+
+private:
+    int num_states = 0;
+    size_t num_words = 0;
+    int num_classes = 1;
+    std::array<std::uint8_t, 256> byte_class{};
+
+    std::vector<std::uint32_t> offsets;        // (state * num_classes + cls) -> targets range
+    std::vector<std::uint32_t> targets;
+    std::vector<std::uint64_t> closures;       // num_states rows of num_words
+    std::vector<std::uint64_t> class_sources;  // states with an edge on cls, per class
+    std::vector<std::uint64_t> final_mask;
+    std::vector<std::uint64_t> start_closure;
+    std::vector<std::uint32_t> back_offsets;      // (state * num_classes + cls) -> sources range
+    std::vector<std::uint32_t> back_sources;
+    std::vector<std::uint32_t> eps_back_offsets;  // state -> epsilon sources range
+    std::vector<std::uint32_t> eps_back_sources;
+
+    // Reverse liveness over the NFA states, built on first use under the
+    // mutex and published with a release store. A copy gets its own mutex.
+    struct LivenessState {
+        std::mutex mutex;
+        std::atomic<bool> built{false};
+
+        LivenessState() = default;
+        LivenessState(const LivenessState& other) : built(other.built.load()) {}
+        LivenessState& operator=(const LivenessState& other) {
+            built = other.built.load();
+            return *this;
+        }
+    };
+    mutable LivenessState liveness_state;
+    mutable ReverseLiveness liveness;
+};
+
 // Regex → NFA using Thompson's construction
 class RegexToNFA {
 public:
@@ -85,6 +161,12 @@ public:
     // Note: this implementation does NOT support escapes like \* or character classes yet.
     static NFA from_regex(const std::string& regex);
 
+    // True if the regex uses only the syntax above, well formed: balanced
+    // parentheses, no empty alternatives or groups, one quantifier per atom.
+    // from_regex then builds exactly the language std::regex (ECMAScript)
+    // would match, except that '.' also matches '\n' and '\r'.
+    static bool is_supported(const std::string& regex);
+
 private:
     // helper pipeline: tokenize, insert explicit concatenation, shunting-yard to postfix,
     // then Thompson build from postfix.
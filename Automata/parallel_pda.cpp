@@ -0,0 +1,205 @@
+#include "parallel_pda.hpp"
+#include "pda_stream.hpp"
+#include <algorithm>
+
+namespace {
+    // The opener a closer matches, or 0
+    constexpr char opener_for(char c) {
+        switch (c) {
+            case ')': return '(';
+            case ']': return '[';
+            case '}': return '{';
+            case '>': return '<';
+            default: return 0;
+        }
+    }
+
+    constexpr bool is_opener(char c) {
+        return c == '(' || c == '[' || c == '{' || c == '<';
+    }
+
+    // Chunk boundaries [0, ..., input.size()]. With keep_runs, a boundary
+    // never splits a run of '*' or '~', whose pairing into "**" and "~~"
+    // depends on where the run starts.
+    std::vector<size_t> chunk_cuts(std::string_view input, size_t chunk_bytes, bool keep_runs) {
+        if (chunk_bytes == 0) chunk_bytes = ParallelPDA::DEFAULT_CHUNK_BYTES;
+        std::vector<size_t> cuts = {0};
+        size_t cut = chunk_bytes;
+        while (cut < input.size()) {
+            while (keep_runs && cut < input.size() && input[cut - 1] == input[cut] &&
+                   (input[cut] == '*' || input[cut] == '~')) {
+                cut++;
+            }
+            if (cut >= input.size()) break;
+            cuts.push_back(cut);
+            cut += chunk_bytes;
+        }
+        cuts.push_back(input.size());
+        return cuts;
+    }
+
+    // A chunk scanned from an empty stack: its demands on the stack
+    // below, then the frames it leaves open (or its first error)
+    struct MarkdownChunk {
+        std::vector<MarkdownDemand> demands;
+        MarkdownMachine machine;
+        bool failed = false;
+    };
+
+    // Checks a chunk's demands against the real stack below it. Sets
+    // resume_at when a '*' the chunk took to open an italic closes one.
+    bool apply_demands(const MarkdownChunk& chunk, MarkdownMachine& machine, size_t& resume_at,
+                       std::vector<std::pair<int, int>>& error_positions, std::string& error_message) {
+        auto fail = [&](int first, int second, const char* message) {
+            error_positions.push_back({first, second});
+            error_message = message;
+            return false;
+        };
+
+        std::vector<MarkdownFrame>& stack = machine.stack;
+        for (const MarkdownDemand& d : chunk.demands) {
+            bool italic_on_top = !stack.empty() && stack.back().symbol == 'I';
+            switch (d.kind) {
+                case MarkdownDemand::POP_BRACKET:
+                    if (stack.empty() || stack.back().symbol != 'P') {
+                        return fail(d.position, d.position, "Mismatch closing bracket");
+                    }
+                    if (stack.back().bracket != opener_for(d.closer)) {
+                        return fail(stack.back().position, d.position, "Bracket type mismatch");
+                    }
+                    stack.pop_back();
+                    break;
+                case MarkdownDemand::NO_ITALIC_BOLD:
+                    if (italic_on_top) {
+                        return fail(d.position, d.position + 1, "Invalid nesting: bold (**) cannot be inside italic (*)");
+                    }
+                    break;
+                case MarkdownDemand::NO_ITALIC_STAR:
+                    if (italic_on_top) {
+                        resume_at = static_cast<size_t>(d.position);
+                        return true;
+                    }
+                    break;
+            }
+        }
+        return true;
+    }
+}
+
+// ==================== BRACKET SUMMARIES ====================
+
+ParallelPDA::BracketSummary ParallelPDA::BracketSummary::of(std::string_view text, size_t base) {
+    BracketSummary summary;
+    for (size_t i = 0; i < text.size(); i++) {
+        char c = text[i];
+        if (is_opener(c)) {
+            summary.openers.push_back({c, base + i});
+        } else if (char open = opener_for(c)) {
+            if (summary.openers.empty()) {
+                summary.closers += c;
+            } else if (summary.openers.back().symbol == open) {
+                summary.openers.pop_back();
+            }
+        }
+    }
+    return summary;
+}
+
+void ParallelPDA::BracketSummary::append(const BracketSummary& right) {
+    for (char c : right.closers) {
+        if (openers.empty()) {
+            closers += c;
+        } else if (openers.back().symbol == opener_for(c)) {
+            openers.pop_back();
+        }
+    }
+    openers.insert(openers.end(), right.openers.begin(), right.openers.end());
+}
+
+// ==================== PARALLEL SIMULATION ====================
+
+BracketValidation ParallelPDA::simulate(std::string_view input, size_t chunk_bytes, WorkStealingPool& pool) {
+    std::vector<size_t> cuts = chunk_cuts(input, chunk_bytes, false);
+    const size_t n = cuts.size() - 1;
+
+    std::vector<BracketSummary> parts(n);
+    if (n == 1) {
+        parts[0] = BracketSummary::of(input, 0);
+    } else {
+        TaskGroup group(pool);
+        for (size_t i = 0; i < n; i++) {
+            group.run([&, i] { parts[i] = BracketSummary::of(input.substr(cuts[i], cuts[i + 1] - cuts[i]), cuts[i]); });
+        }
+        group.wait();
+
+        // Tree reduction: append() is associative, so neighbours combine
+        // pairwise in parallel, log2(n) rounds
+        for (size_t step = 1; step < n; step *= 2) {
+            TaskGroup round(pool);
+            for (size_t i = 0; i + step < n; i += 2 * step) {
+                round.run([&, i, step] { parts[i].append(parts[i + step]); });
+            }
+            round.wait();
+        }
+    }
+
+    // Leftover closers meet the empty stack and are ignored
+    const BracketSummary& total = parts[0];
+    if (total.openers.empty()) return {true, false, BracketValidation::npos};
+    return {false, false, total.openers.front().offset};
+}
+
+bool ParallelPDA::simulate_markdown(std::string_view input,
+                                    std::vector<std::pair<int, int>>& error_positions,
+                                    std::string& error_message,
+                                    size_t chunk_bytes, WorkStealingPool& pool) {
+    MarkdownMachine machine;
+    auto fail = [&](const MarkdownMachine& m) {
+        error_positions.push_back({m.error_first, m.error_second});
+        error_message = m.error_message;
+        return false;
+    };
+
+    // Chunks end where no "**"/"~~" pair is split, so each is scanned to
+    // its end
+    std::vector<size_t> cuts = chunk_cuts(input, chunk_bytes, true);
+    const size_t n = cuts.size() - 1;
+    size_t consumed = 0;
+
+    if (n == 1) {
+        if (!machine.run(input, 0, true, consumed)) return fail(machine);
+    } else {
+        std::vector<MarkdownChunk> chunks(n);
+        {
+            TaskGroup group(pool);
+            for (size_t i = 0; i < n; i++) {
+                group.run([&, i] {
+                    MarkdownChunk& chunk = chunks[i];
+                    chunk.machine.demands = &chunk.demands;
+                    size_t scanned = 0;
+                    chunk.failed = !chunk.machine.run(input.substr(cuts[i], cuts[i + 1] - cuts[i]), cuts[i], true, scanned);
+                });
+            }
+            group.wait();
+        }
+
+        // Combine in order on the real stack; the first failure is the
+        // sequential machine's first error
+        for (size_t i = 0; i < n; i++) {
+            const MarkdownChunk& chunk = chunks[i];
+            size_t resume_at = BracketValidation::npos;
+            if (!apply_demands(chunk, machine, resume_at, error_positions, error_message)) return false;
+            if (resume_at != BracketValidation::npos) {
+                if (!machine.run(input.substr(resume_at, cuts[i + 1] - resume_at), resume_at, true, consumed)) {
+                    return fail(machine);
+                }
+                continue;
+            }
+            if (chunk.failed) return fail(chunk.machine);
+            machine.stack.insert(machine.stack.end(), chunk.machine.stack.begin(), chunk.machine.stack.end());
+        }
+    }
+
+    machine.report_unclosed(error_positions, error_message);
+    return error_positions.empty();
+}
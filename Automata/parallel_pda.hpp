@@ -0,0 +1,87 @@
+#ifndef PARALLEL_PDA_HPP
+#define PARALLEL_PDA_HPP
+
+#include "bracket_validator.hpp"
+#include "work_stealing_pool.hpp"
+#include <cstddef>
+#include <string>
+#include <string_view>
+#include <utility>
+#include <vector>
+
+/**
+ * @class ParallelPDA
+ * @brief Chunk-parallel versions of PDA::simulate() and PDA::simulate_markdown()
+ *
+ * The input is cut into chunks that are scanned concurrently on a
+ * WorkStealingPool. Each chunk runs the stack machine from an empty stack
+ * and is reduced to a summary of how it acts on whatever stack it really
+ * starts from: what it needs to pop from below, and what it leaves open.
+ * The summaries are then combined in order, and the first error is
+ * located from the combined stack. Results are exactly those of the
+ * sequential PDA methods, which remain the reference.
+ *
+ * Inputs shorter than two chunks are scanned on the calling thread.
+ */
+class ParallelPDA {
+public:
+    static constexpr size_t DEFAULT_CHUNK_BYTES = 1u << 20;
+
+    /**
+     * @struct OpenBracket
+     * @brief An opener left on the stack, and where it is
+     */
+    struct OpenBracket {
+        char symbol;
+        size_t offset;
+    };
+
+    /**
+     * @struct BracketSummary
+     * @brief Effect of a span of text on the PDA::simulate() bracket stack
+     *
+     * Running the span against a stack first applies `closers` in order
+     * (each pops a matching opener and is ignored otherwise), then pushes
+     * `openers`. Summaries compose associatively with append().
+     */
+    struct BracketSummary {
+        std::string closers;               ///< Closers that reached the span's empty stack, in order
+        std::vector<OpenBracket> openers;  ///< Openers left open, bottom first
+
+        /**
+         * @brief Summarize text, whose first byte is at offset base
+         */
+        static BracketSummary of(std::string_view text, size_t base);
+
+        /**
+         * @brief Extend this summary by the span right after it
+         */
+        void append(const BracketSummary& right);
+    };
+
+    /**
+     * @brief Balanced-bracket check, same answer as PDA::simulate()
+     *
+     * Unlike validate_brackets() there is no depth limit. error_offset is
+     * the first opener left unclosed; depth_exceeded is always false.
+     */
+    static BracketValidation simulate(std::string_view input,
+                                      size_t chunk_bytes = DEFAULT_CHUNK_BYTES,
+                                      WorkStealingPool& pool = WorkStealingPool::global());
+
+    /**
+     * @brief Markdown structure check, same results as PDA::simulate_markdown()
+     *
+     * Chunk scans assume that a '*' meeting the chunk's empty stack opens
+     * an italic. When the combined stack shows it closes one instead, that
+     * chunk is rescanned sequentially from the '*', so the results stay
+     * exact either way.
+     */
+    static bool simulate_markdown(std::string_view input,
+                                  std::vector<std::pair<int, int>>& error_positions,
+                                  std::string& error_message,
+                                  size_t chunk_bytes = DEFAULT_CHUNK_BYTES,
+                                  WorkStealingPool& pool = WorkStealingPool::global());
+};
+
+#endif // PARALLEL_PDA_HPP
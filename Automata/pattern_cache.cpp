@@ -0,0 +1,114 @@
+#include "pattern_cache.hpp"
+#include <algorithm>
+#include <cctype>
+
+// ==================== COMPILED REGEX ====================
+
+CompiledRegex::CompiledRegex(const std::string& pattern, unsigned f)
+    : source(pattern), flags(f), own_engine(RegexToNFA::is_supported(pattern)) {
+    if (!own_engine) {
+        // Throws std::regex_error for invalid patterns
+        std_regex();
+        return;
+    }
+
+    std::string folded = pattern;
+    if (flags & PATTERN_ICASE) {
+        std::transform(folded.begin(), folded.end(), folded.begin(),
+                       [](unsigned char c) { return static_cast<char>(std::tolower(c)); });
+    }
+    has_wildcard = folded.find('.') != std::string::npos;
+
+    dfa = convert_nfa_to_dfa(RegexToNFA::from_regex(folded));
+    minimize(dfa);
+    dfa.compile();  // compile now so match() only reads
+}
+
+const std::regex& CompiledRegex::std_regex() const {
+    std::call_once(fallback_once, [this] {
+        auto syntax = std::regex_constants::ECMAScript;
+        if (flags & PATTERN_ICASE) syntax |= std::regex_constants::icase;
+        fallback = std::make_unique<std::regex>(source, syntax);
+    });
+    return *fallback;
+}
+
+bool CompiledRegex::match(std::string_view text) const {
+    if (!own_engine ||
+        (has_wildcard && text.find_first_of("\n\r") != std::string_view::npos)) {
+        return std::regex_match(text.begin(), text.end(), std_regex());
+    }
+
+    const bool icase = (flags & PATTERN_ICASE) != 0;
+    int state = dfa.get_start_state();
+    for (char ch : text) {
+        unsigned char c = static_cast<unsigned char>(ch);
+        if (icase) c = static_cast<unsigned char>(std::tolower(c));
+        state = dfa.next_state(state, c);
+        if (state < 0) return false;
+    }
+    return dfa.is_accepting(state);
+}
+
+// ==================== PATTERN CACHE ====================
+
+PatternCache::PatternCache(size_t cap) : capacity(std::max<size_t>(cap, 1)) {
+    counters.capacity = capacity;
+}
+
+PatternCache& PatternCache::global() {
+    static PatternCache cache;
+    return cache;
+}
+
+std::shared_ptr<const CompiledRegex> PatternCache::get(const std::string& pattern, unsigned flags) {
+    Key key(pattern, flags);
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        auto it = index.find(key);
+        if (it != index.end()) {
+            counters.hits++;
+            lru.splice(lru.begin(), lru, it->second);
+            return it->second->second;
+        }
+        counters.misses++;
+    }
+
+    // Compile outside the lock; a pattern can take milliseconds
+    std::shared_ptr<const CompiledRegex> compiled;
+    try {
+        compiled = std::make_shared<const CompiledRegex>(pattern, flags);
+    } catch (const std::regex_error&) {
+        // invalid regex: cached as null
+    }
+
+    std::lock_guard<std::mutex> lock(mutex);
+    auto it = index.find(key);
+    if (it != index.end()) {
+        // Another thread compiled it meanwhile; keep the cached copy
+        lru.splice(lru.begin(), lru, it->second);
+        return it->second->second;
+    }
+    lru.emplace_front(key, compiled);
+    index.emplace(std::move(key), lru.begin());
+    if (lru.size() > capacity) {
+        index.erase(lru.back().first);
+        lru.pop_back();
+        counters.evictions++;
+    }
+    counters.size = lru.size();
+    return compiled;
+}
+
+PatternCache::Stats PatternCache::stats() const {
+    std::lock_guard<std::mutex> lock(mutex);
+    return counters;
+}
+
+void PatternCache::clear() {
+    std::lock_guard<std::mutex> lock(mutex);
+    lru.clear();
+    index.clear();
+    counters = Stats();
+    counters.capacity = capacity;
+}
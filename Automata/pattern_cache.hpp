@@ -0,0 +1,114 @@
+#ifndef PATTERN_CACHE_HPP
+#define PATTERN_CACHE_HPP
+
+#include "dfa_engine.hpp"
+#include <string>
+#include <string_view>
+#include <regex>
+#include <memory>
+#include <mutex>
+#include <list>
+#include <map>
+#include <utility>
+
+/// Pattern compilation flags (part of the cache key)
+enum PatternFlags : unsigned {
+    PATTERN_DEFAULT = 0,
+    PATTERN_ICASE = 1u << 0,  ///< ASCII case-insensitive matching
+};
+
+/**
+ * @class CompiledRegex
+ * @brief A regex compiled once for whole-string matching
+ *
+ * Patterns in the syntax RegexToNFA supports run on the project's own
+ * engine: Thompson NFA -> subset construction -> Hopcroft minimization ->
+ * dense table. Anything else (anchors, escapes, classes, braces) is compiled
+ * with std::regex (ECMAScript). match() gives std::regex_match results
+ * either way. Immutable after construction, so one instance can be shared
+ * between threads.
+ */
+class CompiledRegex {
+public:
+    /**
+     * @brief Compile a pattern
+     * @throws std::regex_error if the pattern is not a valid regex
+     */
+    CompiledRegex(const std::string& pattern, unsigned flags);
+
+    /**
+     * @brief Whether the whole text matches (std::regex_match semantics)
+     */
+    bool match(std::string_view text) const;
+
+    const std::string& pattern() const { return source; }
+    bool uses_own_engine() const { return own_engine; }
+
+private:
+    std::string source;
+    unsigned flags;
+    bool own_engine;
+    bool has_wildcard = false;
+    DFA dfa;
+
+    // std::regex, built up front for unsupported syntax, or on first use
+    // when a '.' pattern meets '\n'/'\r' (which ECMAScript '.' excludes)
+    mutable std::once_flag fallback_once;
+    mutable std::unique_ptr<std::regex> fallback;
+
+    const std::regex& std_regex() const;
+};
+
+/**
+ * @class PatternCache
+ * @brief Thread-safe LRU cache of compiled patterns keyed by (pattern, flags)
+ *
+ * Compiling a pattern (with either engine) costs far more than matching a
+ * word, so every matcher in the program fetches patterns from here instead
+ * of compiling them per call. Invalid patterns are cached too, as null
+ * entries, so they are not recompiled either.
+ */
+class PatternCache {
+public:
+    static constexpr size_t DEFAULT_CAPACITY = 256;
+
+    /**
+     * @struct Stats
+     * @brief Cache counters since construction (or the last clear())
+     */
+    struct Stats {
+        size_t hits = 0;
+        size_t misses = 0;
+        size_t evictions = 0;
+        size_t size = 0;
+        size_t capacity = 0;
+    };
+
+    explicit PatternCache(size_t capacity = DEFAULT_CAPACITY);
+
+    /**
+     * @brief Process-wide cache shared by all matchers
+     */
+    static PatternCache& global();
+
+    /**
+     * @brief Fetch a compiled pattern, compiling it on a miss
+     * @return Compiled pattern, or null if the pattern is invalid
+     */
+    std::shared_ptr<const CompiledRegex> get(const std::string& pattern, unsigned flags = PATTERN_DEFAULT);
+
+    Stats stats() const;
+    void clear();
+
+private:
+    using Key = std::pair<std::string, unsigned>;
+    using Entry = std::pair<Key, std::shared_ptr<const CompiledRegex>>;
+
+    size_t capacity;
+    mutable std::mutex mutex;
+    std::list<Entry> lru;  ///< Most recently used first
+    std::map<Key, std::list<Entry>::iterator> index;
+    Stats counters;
+};
+
+#endif // PATTERN_CACHE_HPP
@@ -1,10 +1,12 @@
 #include "pda_engine.hpp"
 #include "approximate_matcher.hpp"
+#include "scratch_arena.hpp"
 #include <cctype>
 #include <fstream>
 #include <sstream>
 #include <unordered_map>
 #include <stack>
+#include <memory_resource>
 
 using namespace std;
 
@@ -26,97 +28,106 @@ void PDA::add_transition(int from, int to, char input, char pop, const std::stri
     nodes[from].transitions.emplace_back(input, pop, push, to);
 }
 
+void PDA::set_start_state(int state_id) {
+    if (state_id >= 0 && state_id < static_cast<int>(nodes.size())) {
+        start_state = state_id;
+    }
+}
+
 // ==================== MARKDOWN/NESTED STRUCTURE PDA ====================
 
+namespace {
+    // Stack symbols above the bottom marker: B = ** (bold), I = * (italic),
+    // S = ~~ (strikethrough), and the opening brackets themselves
+    const string FRAME_SYMBOLS = "BIS([{<";
+    const string OPENERS = "([{<";
+    const string CLOSERS = ")]}>";
+
+    // Every input byte not in special (byte 0 is the epsilon input)
+    template <typename F>
+    void for_each_other_byte(const string& special, F f) {
+        for (int b = 1; b < 256; b++) {
+            char c = static_cast<char>(b);
+            if (special.find(c) == string::npos) f(c);
+        }
+    }
+
+    // Epsilon moves from check: on to at_bottom if only the bottom marker
+    // is left, else to above, leaving the stack as it is
+    void add_bottom_check(PDA& pda, int check, int at_bottom, int above) {
+        pda.add_transition(check, at_bottom, 0, PDA::STACK_BOTTOM, string(1, PDA::STACK_BOTTOM));
+        for (char f : FRAME_SYMBOLS) pda.add_transition(check, above, 0, f, string(1, f));
+    }
+}
+
 PDA BracketPDA::create_markdown_pda(bool strict_nesting) {
     PDA pda;
     
-    // States:
-    // q0: Start, outside formatting (scanning text)
-    // q1: Inside formatting level 1 (e.g., bold **)
-    // q2: Inside formatting level 2 (e.g., italic * inside bold)
-    // q3: Error state (mismatch detected)
-    // q4: Accept state (balanced formatting)
-    
-    int q0 = pda.add_node(false);  // Start/outside formatting
-    int q1 = pda.add_node(false);  // Inside level 1 formatting (bold/strikethrough)
-    int q2 = pda.add_node(false);  // Inside level 2 formatting (italic inside bold)
-    int q3 = pda.add_node(false);  // Error state (mismatch)
-    int q4 = pda.add_node(true);   // Accept state
-    
-    // Stack symbols: 
-    // B = ** (bold), I = * (italic), S = ~~ (strikethrough), P = (, [, {, <
-    
-    // === OPENING TRANSITIONS ===
-    
-    // Enter bold (**)
-    pda.add_transition(q0, q1, '*', 0, "B");
-    pda.add_transition(q0, q1, '*', 0, "B");
-    
-    // Enter italic (*) - can be inside or outside
-    pda.add_transition(q0, q1, '*', 0, "I");
-    pda.add_transition(q1, q2, '*', 0, "I");  // Nested italic inside bold
-    
-    // Enter strikethrough (~~)
-    pda.add_transition(q0, q1, '~', 0, "S");
-    pda.add_transition(q0, q1, '~', 0, "S");
-    
-    // Enter brackets
-    pda.add_transition(q0, q1, '(', 0, "P");
-    pda.add_transition(q0, q1, '[', 0, "P");
-    pda.add_transition(q0, q1, '{', 0, "P");
-    pda.add_transition(q0, q1, '<', 0, "P");
-    
-    // === CLOSING TRANSITIONS ===
-    
-    // Close bold (**) - must match B on stack
-    pda.add_transition(q1, q0, '*', 'B', "");
-    pda.add_transition(q1, q0, '*', 'B', "");
-    
-    // Close italic (*) - can be I or B
-    pda.add_transition(q1, q0, '*', 'I', "");  // Close italic at level 1
-    pda.add_transition(q2, q1, '*', 'I', "");  // Close nested italic, return to bold
-    
-    // Close strikethrough (~~) - must match S on stack
-    pda.add_transition(q1, q0, '~', 'S', "");
-    pda.add_transition(q1, q0, '~', 'S', "");
-    
-    // Close brackets - must match corresponding opening
-    pda.add_transition(q1, q0, ')', '(', "");
-    pda.add_transition(q1, q0, ']', '[', "");
-    pda.add_transition(q1, q0, '}', '{', "");
-    pda.add_transition(q1, q0, '>', '<', "");
-    
-    // === ERROR TRANSITIONS ===
+    // The same language as PDA::simulate_markdown(), built deterministically.
+    // "**" and "~~" need one byte of lookahead, which a PDA does not have, so
+    // a '*' acts as a single star at once (opening or closing an italic) and
+    // is turned into "**" if the next byte is '*'. The finite control keeps
+    // what the last byte was and whether the stack is down to its bottom
+    // marker, since acceptance is by final state:
+    // t: plain text, pi: a '*' that opened an italic, po: a '*' that closed
+    // one, tl: a single '~'; 0 = bottom marker only, 1 = frames above it
+    int t0 = pda.add_node(true);
+    int t1 = pda.add_node(false);
+    int pi1 = pda.add_node(false);
+    int po0 = pda.add_node(true);
+    int po1 = pda.add_node(false);
+    int tl0 = pda.add_node(true);
+    int tl1 = pda.add_node(false);
+    int check_t = pda.add_node(false);   // After a closing bracket
+    int check_po = pda.add_node(false);  // After a '*' that closed an italic
+    pda.set_start_state(t0);
+    
+    add_bottom_check(pda, check_t, t0, t1);
+    add_bottom_check(pda, check_po, po0, po1);
+    
+    struct Source {
+        int state;
+        int plain;  // Where plain text goes
+        int tilde;  // Where a single '~' goes
+        char last;  // t, i (pi), o (po), ~ (tl)
+    };
+    const Source sources[] = {
+        {t0, t0, tl0, 't'}, {t1, t1, tl1, 't'}, {pi1, t1, tl1, 'i'},
+        {po0, t0, tl0, 'o'}, {po1, t1, tl1, 'o'}, {tl0, t0, tl0, '~'}, {tl1, t1, tl1, '~'},
+    };
     
-    // Mismatch closing - goes to error state
-    if (strict_nesting) {
-        pda.add_transition(q0, q3, '*', 0, "");  // Closing * without opening
-        pda.add_transition(q0, q3, '~', 0, "");
-        pda.add_transition(q0, q3, ')', 0, "");
-        pda.add_transition(q0, q3, ']', 0, "");
-        pda.add_transition(q0, q3, '}', 0, "");
-        pda.add_transition(q0, q3, '>', 0, "");
+    for (const Source& from : sources) {
+        // Text leaves the stack alone
+        for_each_other_byte("*~" + OPENERS + CLOSERS, [&](char c) {
+            pda.add_transition(from.state, from.plain, c, 0, "");
+        });
         
-        // Invalid nesting
-        pda.add_transition(q1, q3, '*', 'I', "");  // Try to close bold with *
-        pda.add_transition(q1, q3, '*', 'B', "");  // Try to close italic with **
-    }
-    
-    // === ACCEPT TRANSITIONS ===
-    
-    // Accept when stack is empty (only $ marker remains)
-    pda.add_transition(q0, q4, 0, '$', "");  // End of input
-    pda.add_transition(q1, q4, 0, '$', "");
-    
-    // Self-loop for text characters (not formatting)
-    for (char c = 32; c <= 126; c++) {
-        if (c != '*' && c != '~' && c != '(' && c != ')' && 
-            c != '[' && c != ']' && c != '{' && c != '}' && 
-            c != '<' && c != '>') {
-            pda.add_transition(q0, q0, c, 0, "");  // Stay in q0 for text
-            pda.add_transition(q1, q1, c, 0, "");  // Stay in q1 for text inside formatting
-            pda.add_transition(q2, q2, c, 0, "");  // Stay in q2 for text inside nested formatting
+        // Brackets: push the opener, pop it with the matching closer
+        for (size_t b = 0; b < OPENERS.size(); b++) {
+            pda.add_transition(from.state, t1, OPENERS[b], 0, string(1, OPENERS[b]));
+            pda.add_transition(from.state, check_t, CLOSERS[b], OPENERS[b], "");
+        }
+        
+        // Strikethrough: the second '~' of a pair pushes S
+        if (from.last == '~') {
+            pda.add_transition(from.state, t1, '~', 0, "S");
+        } else {
+            pda.add_transition(from.state, from.tilde, '~', 0, "");
+        }
+        
+        // Stars
+        if (from.last == 'i') {
+            // "**": the italic just opened becomes bold
+            pda.add_transition(from.state, t1, '*', 'I', "B");
+        } else if (from.last == 'o') {
+            // "**" with an italic on top: invalid nesting, unless allowed
+            if (!strict_nesting) pda.add_transition(from.state, t1, '*', 0, "BI");
+        } else {
+            pda.add_transition(from.state, check_po, '*', 'I', "");
+            pda.add_transition(from.state, pi1, '*', PDA::STACK_BOTTOM, string("I") + PDA::STACK_BOTTOM);
+            for (char f : FRAME_SYMBOLS) {
+                if (f != 'I') pda.add_transition(from.state, pi1, '*', f, string("I") + f);
+            }
         }
     }
     
@@ -314,6 +325,7 @@ PDA BracketPDA::create_toxic_detection_pda(const vector<string>& toxic_patterns,
     int q2 = pda.add_node(false);  // Toxic Detected (state 2)
     int q3 = pda.add_node(false);  // Intermediate (state 3)
     int q4 = pda.add_node(true);   // Accept (state 4 - final
+    pda.set_start_state(q0);
     
     // Opening brackets (push)
     pda.add_transition(q0, q1, '(', '$', "($");
@@ -351,27 +363,24 @@ PDA BracketPDA::create_toxic_detection_pda(const vector<string>& toxic_patterns,
 PDA BracketPDA::create_balanced_bracket_pda() {
     PDA pda;
     
-    // Create states
-    int q0 = pda.add_node(false);  // Start state
-    int q1 = pda.add_node(true);   // Accept state
-    
-    // Push stack marker
-    pda.add_transition(q0, q0, 0, 0, "$");
+    // Create states: the finite control tracks whether the stack is down
+    // to its bottom marker, since acceptance is by final state
+    int q0 = pda.add_node(true);   // Balanced so far (accept)
+    int q1 = pda.add_node(false);  // Inside brackets
+    int check = pda.add_node(false);  // After a pop: back to q0 or q1
+    pda.set_start_state(q0);
     
-    // Opening brackets - push onto stack
-    pda.add_transition(q0, q0, '(', 0, "(");
-    pda.add_transition(q0, q0, '[', 0, "[");
-    pda.add_transition(q0, q0, '{', 0, "{");
-    pda.add_transition(q0, q0, '<', 0, "<");
-    
-    // Closing brackets - pop from stack if matching
-    pda.add_transition(q0, q0, ')', '(', "");
-    pda.add_transition(q0, q0, ']', '[', "");
-    pda.add_transition(q0, q0, '}', '{', "");
-    pda.add_transition(q0, q0, '>', '<', "");
-    
-    // Accept when stack has only $ marker left
-    pda.add_transition(q0, q1, 0, '$', "");
+    for (int q : {q0, q1}) {
+        // Opening brackets - push onto stack
+        for (char open : OPENERS) pda.add_transition(q, q1, open, 0, string(1, open));
+        
+        // Closing brackets - pop from stack if matching
+        for (size_t b = 0; b < CLOSERS.size(); b++) pda.add_transition(q, check, CLOSERS[b], OPENERS[b], "");
+        
+        // Other characters are text
+        for_each_other_byte(OPENERS + CLOSERS, [&](char c) { pda.add_transition(q, q, c, 0, ""); });
+    }
+    add_bottom_check(pda, check, q0, q1);
     
     return pda;
 }
@@ -621,18 +630,20 @@ string PDA::toDotNested() const {
 // ==================== SIMPLE BRACKET CHECK (LEGACY) ====================
 
 bool PDA::simulate(const string& input) {
-    stack<char> st;
+    // Stack lives on the thread's scratch arena: no heap traffic per call
+    ScratchScope scope;
+    pmr::vector<char> st(scope.resource());
     for (char c : input) {
         if (c == '(' || c == '[' || c == '{' || c == '<') {
-            st.push(c);
-        } else if (c == ')' && !st.empty() && st.top() == '(') {
-            st.pop();
-        } else if (c == ']' && !st.empty() && st.top() == '[') {
-            st.pop();
-        } else if (c == '}' && !st.empty() && st.top() == '{') {
-            st.pop();
-        } else if (c == '>' && !st.empty() && st.top() == '<') {
-            st.pop();
+            st.push_back(c);
+        } else if (c == ')' && !st.empty() && st.back() == '(') {
+            st.pop_back();
+        } else if (c == ']' && !st.empty() && st.back() == '[') {
+            st.pop_back();
+        } else if (c == '}' && !st.empty() && st.back() == '{') {
+            st.pop_back();
+        } else if (c == '>' && !st.empty() && st.back() == '<') {
+            st.pop_back();
         }
     }
     return st.empty();
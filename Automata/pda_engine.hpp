@@ -21,6 +21,11 @@ struct PDANode {
     std::vector<std::tuple<char, char, std::string, int>> transitions;  ///< Transitions: (input, pop, push, to_state)
 };
 
+// Transition semantics, as PDARunner executes them: input 0 is an epsilon
+// move; pop 0 leaves the stack alone, any other pop symbol must be on top
+// and is removed; push is written with its first character ending up on
+// top ("($" on '$' leaves '(' above '$'). The stack starts as STACK_BOTTOM.
+
 /**
  * @class PDA
  * @brief Pushdown Automaton implementation for context-free language recognition
@@ -62,6 +67,12 @@ public:
      */
     void add_transition(int from, int to, char input, char pop, const std::string& push);
     
+    /**
+     * @brief Set the start state
+     * @param state_id State to start from (ignored if out of range)
+     */
+    void set_start_state(int state_id);
+    
     /**
      * @brief Simple bracket balancing check
      * 
@@ -156,6 +167,15 @@ public:
      */
     size_t get_state_count() const { return nodes.size(); }
     
+    /**
+     * @brief Get all states with their transition tables
+     * @return States, indexed by ID
+     */
+    const std::vector<PDANode>& get_nodes() const { return nodes; }
+    
+    /// Symbol the stack holds when a run starts
+    static constexpr char STACK_BOTTOM = '$';
+    
     /**
      * @brief Check if a state is accepting
      * @param state_id State ID to check
@@ -181,7 +201,9 @@ public:
      * - Curly braces: {}
      * - Angle brackets: <>
      * 
-     * This demonstrates a classic context-free language.
+     * This demonstrates a classic context-free language. Other bytes
+     * are text; unlike simulate(), a stray closing bracket rejects.
+     * The PDA is deterministic, so DeterministicPDA compiles it.
      * 
      * @return PDA configured for bracket balancing
      */
@@ -190,10 +212,12 @@ public:
     /**
      * @brief Create a PDA for Markdown-like nested structure parsing
      * 
-     * Creates a PDA that can parse nested markdown structures
-     * with proper balancing of headings, lists, and code blocks.
+     * Creates a PDA that can parse nested markdown structures: it
+     * accepts exactly the inputs PDA::simulate_markdown() finds valid
+     * (bar NUL bytes, which a transition cannot read). The PDA is
+     * deterministic, so DeterministicPDA compiles it.
      * 
-     * @param strict_nesting Whether to enforce strict nesting rules
+     * @param strict_nesting Whether to reject bold (**) inside italic (*)
      * @return PDA configured for markdown parsing
      */
     static PDA create_markdown_pda(bool strict_nesting = true);
@@ -0,0 +1,147 @@
+#include "pda_runner.hpp"
+#include "scratch_arena.hpp"
+#include <memory_resource>
+#include <unordered_map>
+#include <unordered_set>
+
+// ==================== TABLE INDEX ====================
+
+PDARunner::PDARunner(const PDA& pda) : start(pda.get_start_state()) {
+    const std::vector<PDANode>& nodes = pda.get_nodes();
+    const size_t n = nodes.size();
+
+    final_state.assign(n, 0);
+    for (size_t s = 0; s < n; s++) final_state[s] = pda.is_final_state(static_cast<int>(s)) ? 1 : 0;
+
+    auto column = [](char input) { return input == 0 ? EPSILON : static_cast<size_t>(static_cast<unsigned char>(input)); };
+    auto valid_target = [n](int to) { return to >= 0 && static_cast<size_t>(to) < n; };
+
+    // Bucket the moves by (state, input byte), keeping their stored order
+    move_begin.assign(n * COLUMNS + 1, 0);
+    for (size_t s = 0; s < n; s++) {
+        for (const auto& [input, pop, push, to] : nodes[s].transitions) {
+            if (valid_target(to)) move_begin[s * COLUMNS + column(input) + 1]++;
+        }
+    }
+    for (size_t i = 1; i < move_begin.size(); i++) move_begin[i] += move_begin[i - 1];
+
+    moves.resize(move_begin.back());
+    std::vector<std::uint32_t> fill(move_begin.begin(), move_begin.end() - 1);
+    for (size_t s = 0; s < n; s++) {
+        for (const auto& [input, pop, push, to] : nodes[s].transitions) {
+            if (!valid_target(to)) continue;
+            // The first push character ends up on top, so push back to front
+            std::uint32_t begin = static_cast<std::uint32_t>(push_pool.size());
+            push_pool.append(push.rbegin(), push.rend());
+            moves[fill[s * COLUMNS + column(input)]++] = {pop, to, begin, static_cast<std::uint32_t>(push_pool.size())};
+        }
+    }
+}
+
+// ==================== RUN ====================
+
+PDARunner::Result PDARunner::run(std::string_view input, const Limits& limits) const {
+    Result result;
+    result.reject_offset = input.size();
+    if (start < 0 || static_cast<size_t>(start) >= final_state.size()) return result;
+
+    ScratchScope scope;
+    std::pmr::memory_resource* arena = scope.resource();
+
+    // Hash-consed stacks: node 0 is the empty stack, every other node is
+    // one symbol on top of its parent
+    struct StackNode {
+        char symbol;
+        std::int32_t parent;
+        std::uint32_t depth;
+    };
+    std::pmr::vector<StackNode> stacks(arena);
+    std::pmr::unordered_map<std::uint64_t, std::int32_t> stack_index(arena);
+    stacks.push_back({0, -1, 0});
+    auto push_symbol = [&](std::int32_t below, char symbol) {
+        std::uint64_t key = (static_cast<std::uint64_t>(below) << 8) | static_cast<unsigned char>(symbol);
+        auto [it, added] = stack_index.try_emplace(key, static_cast<std::int32_t>(stacks.size()));
+        if (added) stacks.push_back({symbol, below, stacks[below].depth + 1});
+        return it->second;
+    };
+
+    // Applies a move to a stack; false if the move does not fit it
+    auto apply = [&](const Move& move, std::int32_t stack, std::int32_t& out) {
+        if (move.pop) {
+            if (stack == 0 || stacks[stack].symbol != move.pop) return false;
+            stack = stacks[stack].parent;
+        }
+        for (std::uint32_t k = move.push_begin; k < move.push_end; k++) {
+            if (stacks[stack].depth >= limits.max_depth) {
+                result.limit_hit = true;
+                return false;
+            }
+            stack = push_symbol(stack, push_pool[k]);
+        }
+        out = stack;
+        return true;
+    };
+
+    // Configurations (state, stack) packed into one word
+    auto pack = [](std::int32_t state, std::int32_t stack) {
+        return (static_cast<std::uint64_t>(state) << 32) | static_cast<std::uint32_t>(stack);
+    };
+    std::pmr::vector<std::uint64_t> current(arena), next(arena);
+    std::pmr::unordered_set<std::uint64_t> seen(arena);
+
+    auto add = [&](std::pmr::vector<std::uint64_t>& set, std::int32_t state, std::int32_t stack) {
+        if (seen.size() >= limits.max_configurations) {
+            result.limit_hit = true;
+            return;
+        }
+        if (seen.insert(pack(state, stack)).second) {
+            set.push_back(pack(state, stack));
+            result.configurations++;
+        }
+    };
+
+    // Epsilon closure, breadth-first: set doubles as the work queue
+    auto close = [&](std::pmr::vector<std::uint64_t>& set) {
+        for (size_t i = 0; i < set.size(); i++) {
+            std::int32_t state = static_cast<std::int32_t>(set[i] >> 32);
+            std::int32_t stack = static_cast<std::int32_t>(set[i] & 0xFFFFFFFFu);
+            size_t cell = static_cast<size_t>(state) * COLUMNS + EPSILON;
+            for (std::uint32_t m = move_begin[cell]; m < move_begin[cell + 1]; m++) {
+                std::int32_t to_stack;
+                if (apply(moves[m], stack, to_stack)) add(set, moves[m].to, to_stack);
+            }
+        }
+    };
+
+    add(current, start, push_symbol(0, PDA::STACK_BOTTOM));
+    close(current);
+
+    for (size_t pos = 0; pos < input.size(); pos++) {
+        next.clear();
+        seen.clear();
+        size_t byte = static_cast<unsigned char>(input[pos]);
+        for (std::uint64_t config : current) {
+            std::int32_t state = static_cast<std::int32_t>(config >> 32);
+            std::int32_t stack = static_cast<std::int32_t>(config & 0xFFFFFFFFu);
+            size_t cell = static_cast<size_t>(state) * COLUMNS + byte;
+            for (std::uint32_t m = move_begin[cell]; m < move_begin[cell + 1]; m++) {
+                std::int32_t to_stack;
+                if (apply(moves[m], stack, to_stack)) add(next, moves[m].to, to_stack);
+            }
+        }
+        close(next);
+        if (next.empty()) {
+            result.reject_offset = pos;
+            return result;
+        }
+        current.swap(next);
+    }
+
+    for (std::uint64_t config : current) {
+        if (final_state[config >> 32]) {
+            result.accepted = true;
+            break;
+        }
+    }
+    return result;
+}
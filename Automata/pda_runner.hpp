@@ -0,0 +1,80 @@
+#ifndef PDA_RUNNER_HPP
+#define PDA_RUNNER_HPP
+
+#include "pda_engine.hpp"
+#include <cstdint>
+#include <string>
+#include <string_view>
+#include <vector>
+
+/**
+ * @class PDARunner
+ * @brief Executes a PDA's transition tables as stored (nondeterministically)
+ *
+ * PDA::simulate() and friends are hand-written checks; this runs whatever
+ * (input, pop, push, to) tuples the PDA holds, so a grammar is defined by
+ * its table alone. Construction indexes the transitions by state and input
+ * byte. A run moves the whole set of reachable configurations (state,
+ * stack) forward one byte at a time, breadth-first, closing over epsilon
+ * moves after each byte. Stacks are hash-consed into a shared tree, so a
+ * configuration is two integers and duplicates reached along different
+ * paths are explored once.
+ *
+ * Epsilon moves that push can make the configuration set infinite; runs
+ * are bounded by a stack depth and a configuration budget, and report
+ * when a bound cut the search short. Acceptance is by final state after
+ * the whole input.
+ */
+class PDARunner {
+public:
+    static constexpr size_t DEFAULT_MAX_DEPTH = 4096;
+    static constexpr size_t DEFAULT_MAX_CONFIGURATIONS = 1u << 16;
+
+    /**
+     * @struct Limits
+     * @brief Bounds on a run's search
+     */
+    struct Limits {
+        size_t max_depth = DEFAULT_MAX_DEPTH;                    ///< Deepest stack explored
+        size_t max_configurations = DEFAULT_MAX_CONFIGURATIONS;  ///< Live configurations per input position
+    };
+
+    /**
+     * @struct Result
+     * @brief Outcome of a run
+     */
+    struct Result {
+        bool accepted = false;
+        bool limit_hit = false;         ///< A bound pruned the search (a reject may be wrong)
+        size_t reject_offset = 0;       ///< First byte no configuration could take (input size if none)
+        size_t configurations = 0;      ///< Configurations explored in total
+    };
+
+    explicit PDARunner(const PDA& pda);
+
+    Result run(std::string_view input, const Limits& limits) const;
+    Result run(std::string_view input) const { return run(input, Limits{}); }
+
+    bool accepts(std::string_view input) const { return run(input).accepted; }
+
+private:
+    struct Move {
+        char pop;                 // 0: no pop
+        std::int32_t to;
+        std::uint32_t push_begin; // push symbols, bottom-most first, in push_pool
+        std::uint32_t push_end;
+    };
+
+    int start = 0;
+    std::vector<std::uint8_t> final_state;
+    // Moves of state s on byte b: moves[move_begin[s * 257 + b] .. move_begin[s * 257 + b + 1]);
+    // column 256 holds the epsilon moves
+    std::vector<std::uint32_t> move_begin;
+    std::vector<Move> moves;
+    std::string push_pool;
+
+    static constexpr size_t EPSILON = 256;
+    static constexpr size_t COLUMNS = 257;
+};
+
+#endif // PDA_RUNNER_HPP
@@ -0,0 +1,152 @@
+#include "pda_stream.hpp"
+
+namespace {
+    // The opener a closer matches, or 0
+    constexpr char opener_for(char c) {
+        switch (c) {
+            case ')': return '(';
+            case ']': return '[';
+            case '}': return '{';
+            case '>': return '<';
+            default: return 0;
+        }
+    }
+
+    constexpr const char* BOLD_IN_ITALIC = "Invalid nesting: bold (**) cannot be inside italic (*)";
+}
+
+// ==================== MARKDOWN MACHINE ====================
+
+bool MarkdownMachine::run(std::string_view text, size_t base, bool at_end, size_t& consumed) {
+    size_t i = 0;
+    for (; i < text.size(); i++) {
+        char c = text[i];
+        int pos = static_cast<int>(base + i);
+        if ((c == '*' || c == '~') && i + 1 == text.size() && !at_end) break;  // may pair with the next byte
+        bool pair = i + 1 < text.size() && text[i + 1] == c;
+
+        if (c == '*' && pair) {
+            if (!stack.empty() && stack.back().symbol == 'I') {
+                consumed = i;
+                return fail(pos, pos + 1, BOLD_IN_ITALIC);
+            }
+            if (stack.empty() && demands) demands->push_back({MarkdownDemand::NO_ITALIC_BOLD, 0, pos});
+            stack.push_back({'B', 0, pos});
+            i++;
+        } else if (c == '~' && pair) {
+            stack.push_back({'S', 0, pos});
+            i++;
+        } else if (c == '*') {
+            if (!stack.empty() && stack.back().symbol == 'I') {
+                stack.pop_back();
+            } else {
+                if (stack.empty() && demands) demands->push_back({MarkdownDemand::NO_ITALIC_STAR, 0, pos});
+                stack.push_back({'I', 0, pos});
+            }
+        } else if (c == '(' || c == '[' || c == '{' || c == '<') {
+            stack.push_back({'P', c, pos});
+        } else if (char open = opener_for(c)) {
+            if (stack.empty() && demands) {
+                demands->push_back({MarkdownDemand::POP_BRACKET, c, pos});
+                continue;
+            }
+            if (stack.empty() || stack.back().symbol != 'P') {
+                consumed = i;
+                return fail(pos, pos, "Mismatch closing bracket");
+            }
+            if (stack.back().bracket != open) {
+                consumed = i;
+                return fail(stack.back().position, pos, "Bracket type mismatch");
+            }
+            stack.pop_back();
+        }
+    }
+    consumed = i;
+    return true;
+}
+
+bool MarkdownMachine::fail(int first, int second, const char* message) {
+    error_first = first;
+    error_second = second;
+    error_message = message;
+    return false;
+}
+
+void MarkdownMachine::report_unclosed(std::vector<std::pair<int, int>>& error_positions, std::string& message) const {
+    for (auto it = stack.rbegin(); it != stack.rend(); ++it) {
+        switch (it->symbol) {
+            case 'B':
+                error_positions.push_back({it->position, it->position + 1});
+                message = "Unclosed bold formatting (**)";
+                break;
+            case 'I':
+                error_positions.push_back({it->position, it->position});
+                message = "Unclosed italic formatting (*)";
+                break;
+            case 'S':
+                error_positions.push_back({it->position, it->position + 1});
+                message = "Unclosed strikethrough formatting (~~)";
+                break;
+            case 'P':
+                error_positions.push_back({it->position, it->position});
+                message = "Unclosed bracket";
+                break;
+        }
+    }
+}
+
+// ==================== STREAM STATE ====================
+
+bool PDAStreamState::feed(std::string_view fragment) {
+    if (has_failed || finished) return !has_failed;
+    if (fragment.empty()) return true;
+
+    // A '*' or '~' held back from the last fragment pairs with this one's
+    // first byte, or stands alone
+    if (pending) {
+        const char held[2] = {pending, fragment[0]};
+        bool paired = fragment[0] == pending;
+        pending = 0;
+        if (!scan(std::string_view(held, paired ? 2 : 1), true)) return false;
+        if (paired) fragment.remove_prefix(1);
+    }
+    return scan(fragment, false);
+}
+
+bool PDAStreamState::finish() {
+    if (finished) return errors.empty();
+    finished = true;
+    if (has_failed) return false;
+
+    if (pending) {
+        const char held = pending;
+        pending = 0;
+        if (!scan(std::string_view(&held, 1), true)) return false;
+    }
+    machine.report_unclosed(errors, message);
+    return errors.empty();
+}
+
+void PDAStreamState::reset() {
+    machine.stack.clear();
+    offset = 0;
+    pending = 0;
+    has_failed = false;
+    finished = false;
+    errors.clear();
+    message.clear();
+}
+
+bool PDAStreamState::scan(std::string_view text, bool at_end) {
+    size_t consumed = 0;
+    bool ok = machine.run(text, offset, at_end, consumed);
+    offset += consumed;
+    if (!ok) {
+        has_failed = true;
+        errors.push_back({machine.error_first, machine.error_second});
+        message = machine.error_message;
+        return false;
+    }
+    if (consumed < text.size()) pending = text[consumed];  // the trailing '*' or '~'
+    return true;
+}
@@ -0,0 +1,126 @@
+#ifndef PDA_STREAM_HPP
+#define PDA_STREAM_HPP
+
+#include <cstddef>
+#include <string>
+#include <string_view>
+#include <utility>
+#include <vector>
+
+/**
+ * @struct MarkdownFrame
+ * @brief Stack frame of the PDA::simulate_markdown() machine
+ */
+struct MarkdownFrame {
+    char symbol;   ///< B (bold), I (italic), S (strikethrough), P (bracket)
+    char bracket;  ///< The opener, for P
+    int position;  ///< Offset in the input where it was opened
+};
+
+/**
+ * @struct MarkdownDemand
+ * @brief What a span scanned from an empty stack needs from the stack below
+ */
+struct MarkdownDemand {
+    enum Kind : char {
+        POP_BRACKET,     ///< A closer: the top must be its opener, which is popped
+        NO_ITALIC_BOLD,  ///< "**": the top must not be an italic
+        NO_ITALIC_STAR,  ///< '*' taken to open an italic: the top must not be one
+    };
+
+    Kind kind;
+    char closer;
+    int position;
+};
+
+/**
+ * @class MarkdownMachine
+ * @brief The PDA::simulate_markdown() stack machine, fed piecewise
+ *
+ * Shared by PDAStreamState and ParallelPDA. By default an empty stack is
+ * the bottom marker. With demands set, the stack instead starts as a
+ * stand-in for an unknown stack below the span: operations that would
+ * look beneath it are appended to *demands and the scan goes on.
+ */
+class MarkdownMachine {
+public:
+    std::vector<MarkdownFrame> stack;
+    std::vector<MarkdownDemand>* demands = nullptr;
+
+    // First error, once run() has returned false
+    int error_first = 0;
+    int error_second = 0;
+    const char* error_message = nullptr;
+
+    /**
+     * @brief Scan text, whose first byte is at offset base in the input
+     *
+     * A "**" or "~~" pair is recognized only inside text, so unless
+     * at_end is set, a trailing '*' or '~' that could pair with the next
+     * byte is left unconsumed.
+     *
+     * @param consumed Receives the number of bytes scanned
+     * @return false at the first error
+     */
+    bool run(std::string_view text, size_t base, bool at_end, size_t& consumed);
+
+    /**
+     * @brief Append the errors for frames left open, innermost first, as
+     *        PDA::simulate_markdown() reports them at the end of input
+     */
+    void report_unclosed(std::vector<std::pair<int, int>>& error_positions, std::string& message) const;
+
+private:
+    bool fail(int first, int second, const char* message);
+};
+
+/**
+ * @class PDAStreamState
+ * @brief Resumable PDA::simulate_markdown() for input arriving in fragments
+ *
+ * Holds the machine's stack between calls, so each feed() costs time in
+ * the fragment's size only, instead of a rescan of everything received so
+ * far. After the last fragment, finish() gives the same result, error
+ * positions and message as PDA::simulate_markdown() on the concatenation.
+ * Copyable: keep a copy as a checkpoint to rewind to, e.g. on an edit.
+ */
+class PDAStreamState {
+public:
+    /**
+     * @brief Scan the next fragment
+     * @return false once the input seen so far has an error (further
+     *         fragments are then ignored)
+     */
+    bool feed(std::string_view fragment);
+
+    /**
+     * @brief End of input: report open formatting and brackets
+     * @return true if the whole input is well formed
+     */
+    bool finish();
+
+    /**
+     * @brief Start over for a new message
+     */
+    void reset();
+
+    bool failed() const { return has_failed; }
+    size_t bytes_fed() const { return offset + (pending ? 1 : 0); }
+    size_t depth() const { return machine.stack.size(); }
+
+    const std::vector<std::pair<int, int>>& error_positions() const { return errors; }
+    const std::string& error_message() const { return message; }
+
+private:
+    MarkdownMachine machine;
+    size_t offset = 0;  ///< Input bytes scanned
+    char pending = 0;   ///< Trailing '*' or '~' waiting for the next byte
+    bool has_failed = false;
+    bool finished = false;
+    std::vector<std::pair<int, int>> errors;
+    std::string message;
+
+    bool scan(std::string_view text, bool at_end);
+};
+
+#endif // PDA_STREAM_HPP
@@ -0,0 +1,75 @@
+#include "scratch_arena.hpp"
+#include <algorithm>
+#include <cstdint>
+#include <new>
+
+ScratchArena::ScratchArena(size_t initial_bytes)
+    : buffer(std::make_unique_for_overwrite<std::byte[]>(initial_bytes)),
+      buffer_size(initial_bytes),
+      initial_size(initial_bytes) {
+}
+
+ScratchArena::~ScratchArena() {
+    reset();
+}
+
+ScratchArena& ScratchArena::for_this_thread() {
+    static thread_local ScratchArena arena;
+    return arena;
+}
+
+void* ScratchArena::do_allocate(size_t bytes, size_t alignment) {
+    // Bump within the buffer
+    std::uintptr_t base = reinterpret_cast<std::uintptr_t>(buffer.get());
+    std::uintptr_t aligned = (base + used + alignment - 1) & ~(static_cast<std::uintptr_t>(alignment) - 1);
+    size_t end = static_cast<size_t>(aligned - base) + bytes;
+    if (end <= buffer_size) {
+        used = end;
+        return reinterpret_cast<void*>(aligned);
+    }
+
+    // Out of room: a heap block of its own, freed at reset()
+    size_t block_alignment = std::max(alignment, alignof(OverflowBlock));
+    size_t header = std::max(sizeof(OverflowBlock), alignment);
+    void* raw = ::operator new(header + bytes, std::align_val_t(block_alignment));
+    OverflowBlock* block = static_cast<OverflowBlock*>(raw);
+    block->next = overflow;
+    block->alignment = block_alignment;
+    overflow = block;
+    overflow_bytes += bytes + alignment;
+    return static_cast<std::byte*>(raw) + header;
+}
+
+void ScratchArena::reset() {
+    size_t high_water = used + overflow_bytes;
+    if (overflow) {
+        while (overflow) {
+            OverflowBlock* next = overflow->next;
+            ::operator delete(overflow, std::align_val_t(overflow->alignment));
+            overflow = next;
+        }
+        overflow_bytes = 0;
+
+        // Grow once so the same workload fits next time
+        size_t grown = std::max(buffer_size * 2, high_water + high_water / 2);
+        buffer = std::make_unique_for_overwrite<std::byte[]>(grown);
+        buffer_size = grown;
+        quiet_resets = 0;
+        quiet_high_water = 0;
+    } else if (buffer_size > initial_size && high_water < buffer_size / 4) {
+        // The buffer grew for a burst that is over: shrink it once it has
+        // stayed mostly unused for a while, keeping room for what is used now
+        quiet_high_water = std::max(quiet_high_water, high_water);
+        if (++quiet_resets == SHRINK_AFTER_RESETS) {
+            size_t shrunk = std::max(initial_size, 2 * quiet_high_water);
+            buffer = std::make_unique_for_overwrite<std::byte[]>(shrunk);
+            buffer_size = shrunk;
+            quiet_resets = 0;
+            quiet_high_water = 0;
+        }
+    } else {
+        quiet_resets = 0;
+        quiet_high_water = 0;
+    }
+    used = 0;
+}
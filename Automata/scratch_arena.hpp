@@ -0,0 +1,97 @@
+#ifndef SCRATCH_ARENA_HPP
+#define SCRATCH_ARENA_HPP
+
+#include <cstddef>
+#include <memory>
+#include <memory_resource>
+
+/**
+ * @class ScratchArena
+ * @brief Per-thread monotonic memory resource for per-message scratch data
+ *
+ * Allocation is a pointer bump in one buffer and deallocation is a no-op;
+ * everything is released at once by reset(). When a message needs more
+ * than the buffer holds, the excess comes from the global heap and the
+ * next reset() regrows the buffer to the high-water mark, so after the
+ * first few messages analysis makes no heap allocations for scratch data.
+ * A grown buffer is shrunk again once SHRINK_AFTER_RESETS resets in a row
+ * have used less than a quarter of it, so one huge message does not pin
+ * its memory to the thread for good.
+ *
+ * Analyzers take it through std::pmr containers and bracket each message
+ * with a ScratchScope.
+ */
+class ScratchArena : public std::pmr::memory_resource {
+public:
+    static constexpr size_t DEFAULT_BYTES = 64u << 10;
+    static constexpr size_t SHRINK_AFTER_RESETS = 256;
+
+    explicit ScratchArena(size_t initial_bytes = DEFAULT_BYTES);
+    ~ScratchArena() override;
+
+    ScratchArena(const ScratchArena&) = delete;
+    ScratchArena& operator=(const ScratchArena&) = delete;
+
+    /**
+     * @brief The calling thread's arena
+     */
+    static ScratchArena& for_this_thread();
+
+    /**
+     * @brief Release everything allocated since the last reset
+     */
+    void reset();
+
+    size_t capacity() const { return buffer_size; }
+
+private:
+    friend class ScratchScope;
+
+    struct OverflowBlock {
+        OverflowBlock* next;
+        size_t alignment;
+    };
+
+    std::unique_ptr<std::byte[]> buffer;
+    size_t buffer_size;
+    size_t initial_size;
+    size_t used = 0;
+    size_t quiet_resets = 0;      // Consecutive resets using under a quarter of a grown buffer
+    size_t quiet_high_water = 0;  // Most any of them used
+    OverflowBlock* overflow = nullptr;
+    size_t overflow_bytes = 0;
+    int scope_depth = 0;
+
+    void* do_allocate(size_t bytes, size_t alignment) override;
+    void do_deallocate(void*, size_t, size_t) override {}
+    bool do_is_equal(const std::pmr::memory_resource& other) const noexcept override {
+        return this == &other;
+    }
+};
+
+/**
+ * @class ScratchScope
+ * @brief Resets the arena when the outermost scope on it ends
+ *
+ * Scopes nest: a helper that opens its own scope inside a message's scope
+ * does not release memory the caller is still using.
+ */
+class ScratchScope {
+public:
+    explicit ScratchScope(ScratchArena& arena = ScratchArena::for_this_thread()) : arena(arena) {
+        arena.scope_depth++;
+    }
+    ~ScratchScope() {
+        if (--arena.scope_depth == 0) arena.reset();
+    }
+
+    ScratchScope(const ScratchScope&) = delete;
+    ScratchScope& operator=(const ScratchScope&) = delete;
+
+    std::pmr::memory_resource* resource() const { return &arena; }
+
+private:
+    ScratchArena& arena;
+};
+
+#endif // SCRATCH_ARENA_HPP
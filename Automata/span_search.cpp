@@ -0,0 +1,69 @@
+#include "span_search.hpp"
+#include <map>
+
+// ==================== REVERSE LIVENESS ====================
+
+ReverseLiveness::ReverseLiveness(int num_elements, const std::array<std::uint8_t, 256>& classes, int class_count,
+                                 const std::vector<int>& finals, const std::vector<Edge>& edges)
+    : num_words((static_cast<size_t>(num_elements) + 63) / 64), num_classes(class_count), byte_class(classes) {
+    if (num_words == 0) num_words = 1;
+    const size_t C = static_cast<size_t>(num_classes);
+
+    // Reversed edges in CSR form: predecessors of (to, cls)
+    std::vector<std::uint32_t> pred_begin(static_cast<size_t>(num_elements) * C + 1, 0);
+    for (const Edge& e : edges) pred_begin[static_cast<size_t>(e.to) * C + e.cls + 1]++;
+    for (size_t i = 1; i < pred_begin.size(); i++) pred_begin[i] += pred_begin[i - 1];
+    std::vector<int> preds(edges.size());
+    std::vector<std::uint32_t> fill(pred_begin.begin(), pred_begin.end() - 1);
+    for (const Edge& e : edges) preds[fill[static_cast<size_t>(e.to) * C + e.cls]++] = e.from;
+
+    std::vector<std::uint64_t> final_set(num_words, 0);
+    for (int f : finals) final_set[f / 64] |= 1ULL << (f % 64);
+
+    std::map<std::vector<std::uint64_t>, std::int32_t> ids;
+    auto intern = [&](const std::vector<std::uint64_t>& set) {
+        auto [it, added] = ids.try_emplace(set, static_cast<std::int32_t>(ids.size()));
+        if (added) sets.insert(sets.end(), set.begin(), set.end());
+        return it->second;
+    };
+
+    intern(final_set);
+    std::vector<std::uint64_t> next(num_words);
+    for (size_t cur = 0; cur < ids.size(); cur++) {
+        if (ids.size() > MAX_STATES) {
+            sets.clear();
+            table.clear();
+            return;
+        }
+        table.resize((cur + 1) * C);
+        for (size_t c = 0; c < C; c++) {
+            next = final_set;
+            for (size_t w = 0; w < num_words; w++) {
+                std::uint64_t bits = sets[cur * num_words + w];
+                while (bits) {
+                    size_t y = w * 64 + static_cast<size_t>(__builtin_ctzll(bits));
+                    bits &= bits - 1;
+                    for (std::uint32_t i = pred_begin[y * C + c]; i < pred_begin[y * C + c + 1]; i++) {
+                        next[preds[i] / 64] |= 1ULL << (preds[i] % 64);
+                    }
+                }
+            }
+            // intern() may grow sets, so look the row up afresh
+            std::int32_t to = intern(next);
+            table[cur * C + c] = to;
+        }
+    }
+    built = true;
+}
+
+bool ReverseLiveness::scan(std::string_view text, std::vector<std::int32_t>& at) const {
+    if (!built) return false;
+    at.resize(text.size() + 1);
+    std::int32_t state = 0;  // The final set: only an empty prefix is left
+    at[text.size()] = state;
+    for (size_t p = text.size(); p-- > 0;) {
+        state = table[static_cast<size_t>(state) * num_classes + byte_class[static_cast<unsigned char>(text[p])]];
+        at[p] = state;
+    }
+    return true;
+}
@@ -0,0 +1,129 @@
+#ifndef SPAN_SEARCH_HPP
+#define SPAN_SEARCH_HPP
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <string_view>
+#include <utility>
+#include <vector>
+
+/**
+ * @class ReverseLiveness
+ * @brief For each position of a text, the automaton states from which the
+ *        rest of the text still has an accepted prefix
+ *
+ * Built over the elements of a forward automaton (DFA states, or NFA
+ * states of a closed state set) from its edges: an edge (x, cls, y) says
+ * that reading a byte of class cls from x puts y in the next set. The
+ * reverse automaton is the subset DFA of the reversed edges with the
+ * final elements re-injected at every position, so scanning a text
+ * backwards once labels every position p with the set
+ *
+ *   R(p) = F ∪ { x : some edge (x, text[p], y) has y in R(p + 1) },  R(n) = F
+ *
+ * i.e. the elements from which text[p..] has a prefix the automaton
+ * accepts. find_leftmost_longest() uses it to stop a forward scan as soon
+ * as no longer match is possible.
+ */
+class ReverseLiveness {
+public:
+    static constexpr size_t MAX_STATES = 4096;
+
+    struct Edge {
+        int from;
+        int cls;
+        int to;
+    };
+
+    ReverseLiveness() = default;
+    ReverseLiveness(int num_elements, const std::array<std::uint8_t, 256>& byte_class, int num_classes,
+                    const std::vector<int>& finals, const std::vector<Edge>& edges);
+
+    /**
+     * @brief false if the reverse automaton outgrew MAX_STATES (it is then
+     *        empty and must not be scanned)
+     */
+    bool ok() const { return built; }
+
+    /**
+     * @brief Label positions 0 .. text.size() with reverse state ids;
+     *        false, labelling nothing, if !ok()
+     */
+    bool scan(std::string_view text, std::vector<std::int32_t>& at) const;
+
+    bool contains(std::int32_t id, int element) const {
+        return (sets[static_cast<size_t>(id) * num_words + element / 64] >> (element % 64)) & 1;
+    }
+    bool intersects(std::int32_t id, const std::uint64_t* set) const {
+        const std::uint64_t* live = &sets[static_cast<size_t>(id) * num_words];
+        for (size_t w = 0; w < num_words; w++) {
+            if (live[w] & set[w]) return true;
+        }
+        return false;
+    }
+
+private:
+    bool built = false;
+    size_t num_words = 0;
+    int num_classes = 0;
+    std::array<std::uint8_t, 256> byte_class{};
+    std::vector<std::uint64_t> sets;    // state i: words [i*W, (i+1)*W)
+    std::vector<std::int32_t> table;    // state i: row [i*C, (i+1)*C)
+};
+
+/**
+ * @brief Leftmost-longest, non-overlapping, non-empty match spans
+ *        [start, end), for any anchored forward automaton
+ *
+ * The liveness labels the text, as ReverseLiveness does:
+ *   bool scan(std::string_view text, std::vector<std::int32_t>& at);
+ *                                 label positions 0 .. text.size(), or
+ *                                 return false if it cannot
+ *
+ * The scanner runs the automaton from its start state:
+ *   void reset();                 back to the start state
+ *   bool step(unsigned char c);   false once no state is left
+ *   bool accepting() const;
+ *   bool live(const Liveness&, std::int32_t id) const;
+ *                                 the current state meets the label id
+ *
+ * With the text labelled, a candidate start is taken only if one byte from
+ * it is still live, and the longest-match scan from it stops at the first
+ * position after the match end, so every byte is scanned a bounded number
+ * of times: linear time. Without (the reverse automaton was too large),
+ * every start is tried with a scan that runs until the automaton dies,
+ * which is quadratic in the worst case.
+ */
+template <typename Liveness, typename Scanner>
+std::vector<std::pair<int, int>> find_leftmost_longest(std::string_view text, const Liveness& liveness,
+                                                       Scanner& scanner) {
+    std::vector<std::pair<int, int>> spans;
+    const size_t n = text.size();
+    std::vector<std::int32_t> at;
+    const bool pruned = liveness.scan(text, at);
+    auto live = [&](size_t pos) { return !pruned || scanner.live(liveness, at[pos]); };
+
+    size_t start = 0;
+    while (start < n) {
+        scanner.reset();
+        if (!scanner.step(static_cast<unsigned char>(text[start])) || !live(start + 1)) {
+            start++;
+            continue;
+        }
+        size_t end = scanner.accepting() ? start + 1 : 0;
+        for (size_t i = start + 1; i < n; i++) {
+            if (!scanner.step(static_cast<unsigned char>(text[i])) || !live(i + 1)) break;
+            if (scanner.accepting()) end = i + 1;
+        }
+        if (end == 0) {
+            start++;  // Only where unlabelled: a live byte always leads to a match
+            continue;
+        }
+        spans.push_back({static_cast<int>(start), static_cast<int>(end)});
+        start = end;
+    }
+    return spans;
+}
+
+#endif // SPAN_SEARCH_HPP
@@ -0,0 +1,170 @@
+#ifndef STATIC_LEXICON_HPP
+#define STATIC_LEXICON_HPP
+
+#include <array>
+#include <bit>
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <string_view>
+#include <vector>
+
+/**
+ * @struct FixedString
+ * @brief String literal usable as a template argument
+ */
+template <size_t N>
+struct FixedString {
+    char chars[N] = {};
+
+    constexpr FixedString(const char (&s)[N]) {
+        for (size_t i = 0; i < N; i++) chars[i] = s[i];
+    }
+
+    constexpr std::string_view view() const { return std::string_view(chars, N - 1); }
+};
+
+/**
+ * @class StaticLexicon
+ * @brief Aho-Corasick automaton for a word list fixed at compile time
+ *
+ * The same automaton AhoCorasick builds at runtime (dense goto table over
+ * byte classes, failure transitions folded in), but built by constexpr
+ * evaluation into static tables: nothing is constructed at startup, and
+ * with the tables and their sizes known to the compiler the scan loop
+ * needs no indirection through heap storage. Each state's outputs,
+ * including those reached through failure links, are precomputed as one
+ * bitmask. Matching is case-sensitive.
+ *
+ * Use it for built-in blocklists; patterns supplied at runtime go through
+ * AhoCorasick.
+ *
+ * @code
+ * using Blocklist = StaticLexicon<"idiot", "stupid">;
+ * int s = Blocklist::next_state(Blocklist::start_state(), 'i');
+ * @endcode
+ */
+template <FixedString... Words>
+class StaticLexicon {
+public:
+    static constexpr size_t WORD_COUNT = sizeof...(Words);
+    static_assert(WORD_COUNT > 0 && WORD_COUNT <= 64, "outputs are kept as a 64-bit mask");
+
+    static constexpr std::array<std::string_view, WORD_COUNT> words = {Words.view()...};
+
+    static constexpr size_t pattern_count() { return WORD_COUNT; }
+
+    /**
+     * @brief The words as strings, in id order
+     */
+    static std::vector<std::string> word_list() {
+        return std::vector<std::string>(words.begin(), words.end());
+    }
+
+    // Stepping API, as AhoCorasick's
+    static constexpr int start_state() { return 0; }
+    static constexpr int next_state(int state, unsigned char c) {
+        return tables.goto_table[static_cast<size_t>(state) * NUM_CLASSES + tables.byte_class[c]];
+    }
+
+    /**
+     * @brief Call f(pattern_id) for every word ending at this state, in
+     *        ascending id order
+     */
+    template <typename F>
+    static constexpr void for_each_output(int state, F&& f) {
+        for (std::uint64_t mask = tables.outputs[state]; mask; mask &= mask - 1) {
+            f(std::countr_zero(mask));
+        }
+    }
+
+    /**
+     * @brief Whether any word ends at this state
+     */
+    static constexpr bool has_output(int state) { return tables.outputs[state] != 0; }
+
+private:
+    // Upper bound on trie states: one per word byte, plus the root
+    static constexpr size_t MAX_STATES = (Words.view().size() + ... + 0) + 1;
+
+    // Every byte used by a word gets its own class; the rest share class 0
+    static constexpr std::array<std::uint8_t, 256> make_byte_class() {
+        std::array<std::uint8_t, 256> byte_class{};
+        int next = 1;
+        for (std::string_view w : words) {
+            for (char ch : w) {
+                unsigned char c = static_cast<unsigned char>(ch);
+                if (byte_class[c] == 0) byte_class[c] = static_cast<std::uint8_t>(next++);
+            }
+        }
+        return byte_class;
+    }
+
+    static constexpr size_t count_classes() {
+        std::array<std::uint8_t, 256> byte_class = make_byte_class();
+        size_t k = 0;
+        for (std::uint8_t cls : byte_class) k = cls > k ? cls : k;
+        return k + 1;
+    }
+
+    static constexpr size_t NUM_CLASSES = count_classes();
+
+    struct Tables {
+        std::array<std::uint8_t, 256> byte_class{};
+        std::array<std::int32_t, MAX_STATES * NUM_CLASSES> goto_table{};
+        std::array<std::uint64_t, MAX_STATES> outputs{};
+    };
+
+    static constexpr Tables build() {
+        Tables t;
+        t.byte_class = make_byte_class();
+        const size_t k = NUM_CLASSES;
+        for (auto& v : t.goto_table) v = -1;
+
+        // 1. Trie
+        size_t num_states = 1;
+        for (size_t id = 0; id < WORD_COUNT; id++) {
+            size_t state = 0;
+            for (char ch : words[id]) {
+                size_t slot = state * k + t.byte_class[static_cast<unsigned char>(ch)];
+                if (t.goto_table[slot] < 0) t.goto_table[slot] = static_cast<std::int32_t>(num_states++);
+                state = static_cast<size_t>(t.goto_table[slot]);
+            }
+            t.outputs[state] |= std::uint64_t{1} << id;
+        }
+
+        // 2. Failure links in BFS order, folding missing edges into the
+        //    table and each state's failure outputs into its own
+        std::array<std::int32_t, MAX_STATES> fail{};
+        std::array<std::int32_t, MAX_STATES> queue{};
+        size_t tail = 0;
+        for (size_t c = 0; c < k; c++) {
+            std::int32_t& v = t.goto_table[c];
+            if (v < 0) {
+                v = 0;
+            } else {
+                queue[tail++] = v;
+            }
+        }
+        for (size_t head = 0; head < tail; head++) {
+            std::int32_t u = queue[head];
+            std::int32_t f = fail[u];
+            t.outputs[u] |= t.outputs[f];
+            for (size_t c = 0; c < k; c++) {
+                std::int32_t& v = t.goto_table[static_cast<size_t>(u) * k + c];
+                std::int32_t via_fail = t.goto_table[static_cast<size_t>(f) * k + c];
+                if (v < 0) {
+                    v = via_fail;
+                } else {
+                    fail[v] = via_fail;
+                    queue[tail++] = v;
+                }
+            }
+        }
+        return t;
+    }
+
+    static constexpr Tables tables = build();
+};
+
+#endif // STATIC_LEXICON_HPP
@@ -0,0 +1,58 @@
+#include "check.hpp"
+#include "alloc_counter.hpp"
+#include "toxicity_analyzer.hpp"
+#include <cstdint>
+#include <new>
+#include <span>
+#include <string_view>
+#include <vector>
+
+// Once warmed up, batch analysis makes no heap allocations on the calling
+// thread: scratch data lives in the thread's ScratchArena and results in
+// the reused BatchResults. Built with AUTOMATA_COUNT_ALLOCATIONS.
+
+int main() {
+    CHECK(alloc_counter::enabled());
+    std::uint64_t probe = alloc_counter::thread_allocations();
+    ::operator delete(::operator new(16));
+    CHECK(alloc_counter::thread_allocations() == probe + 1);
+
+    // The array, aligned and nothrow forms count too, and the sized
+    // deletes free what they allocated
+    probe = alloc_counter::thread_allocations();
+    ::operator delete(::operator new(16), std::size_t{16});
+    ::operator delete[](::operator new[](16));
+    ::operator delete[](::operator new[](16), std::size_t{16});
+    ::operator delete(::operator new(64, std::align_val_t{64}), std::size_t{64}, std::align_val_t{64});
+    ::operator delete[](::operator new[](64, std::align_val_t{64}), std::align_val_t{64});
+    ::operator delete(::operator new(16, std::nothrow), std::nothrow);
+    CHECK(alloc_counter::thread_allocations() == probe + 6);
+
+    const std::vector<std::string_view> messages = {
+        "hello there, how are you?",
+        "you are an idiot",
+        "what a stupid (and dumb) idea",
+        "this is trash [unbalanced",
+        "**bold** and ~~struck~~ text",
+        "you absolute idoit, stupd move",
+        "{[()]} balanced { brackets } [here]",
+        "__underlined__ *emphasis* and **unclosed",
+        "",
+    };
+
+    ToxicityAnalyzer analyzer(false);
+    ToxicityAnalyzer::BatchResults results;
+    for (int round = 0; round < 4; round++) analyzer.analyze_batch(messages, results);
+    CHECK(results.size() == messages.size());
+
+    const int N = 1000;
+    std::uint64_t before = alloc_counter::thread_allocations();
+    for (int round = 0; round < N; round++) analyzer.analyze_batch(messages, results);
+    std::uint64_t after = alloc_counter::thread_allocations();
+    if (after != before) {
+        std::cerr << (after - before) << " allocations in " << N << " batches\n";
+    }
+    CHECK(after == before);
+    CHECK(results.size() == messages.size());
+    return test_result();
+}
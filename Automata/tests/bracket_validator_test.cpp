@@ -0,0 +1,108 @@
+#include "check.hpp"
+#include "bracket_validator.hpp"
+#include "cpu_features.hpp"
+#include "pda_engine.hpp"
+#include <random>
+#include <string>
+#include <vector>
+
+// validate_brackets (AVX2 when available) and validate_brackets_scalar
+// against an unbounded reference stack and PDA::simulate
+
+static BracketValidation reference(const std::string& text) {
+    std::vector<std::pair<char, size_t>> stack;
+    for (size_t i = 0; i < text.size(); i++) {
+        char c = text[i];
+        char open = c == ')' ? '(' : c == ']' ? '[' : c == '}' ? '{' : c == '>' ? '<' : 0;
+        if (c == '(' || c == '[' || c == '{' || c == '<') {
+            if (stack.size() == MAX_BRACKET_DEPTH) return {false, true, i};
+            stack.push_back({c, i});
+        } else if (open && !stack.empty() && stack.back().first == open) {
+            stack.pop_back();
+        }
+    }
+    if (!stack.empty()) return {false, false, stack.front().second};
+    return {true, false, BracketValidation::npos};
+}
+
+static bool same(const BracketValidation& a, const BracketValidation& b) {
+    return a.valid == b.valid && a.depth_exceeded == b.depth_exceeded && a.error_offset == b.error_offset;
+}
+
+static void check_text(const std::string& text) {
+    BracketValidation expected = reference(text);
+    CHECK(same(validate_brackets(text), expected));
+    CHECK(same(validate_brackets_scalar(text), expected));
+}
+
+static void test_random() {
+    std::mt19937 rng(21);
+    PDA pda;
+    const std::string alphabet = "()[]{}<>ab \x80";
+    for (int round = 0; round < 5000; round++) {
+        std::string text(rng() % 200, 'a');
+        for (char& c : text) c = rng() % 3 ? alphabet[rng() % alphabet.size()] : 'x';
+        check_text(text);
+        CHECK(validate_brackets(text).valid == pda.simulate(text));
+    }
+}
+
+// Every length around the 32-byte block, with the deciding byte at every
+// position: inside whole blocks and in the scalar tail
+static void test_tails() {
+    for (size_t length : {1, 31, 32, 33, 63, 64, 65, 95, 96, 97, 130}) {
+        for (size_t at = 0; at < length; at++) {
+            std::string text(length, '.');
+            text[at] = '[';
+            BracketValidation open = validate_brackets(text);
+            CHECK(!open.valid && open.error_offset == at);
+            check_text(text);
+
+            text[at] = '}';
+            CHECK(validate_brackets(text).valid);  // A stray closer is ignored
+            check_text(text);
+
+            // A pair straddling the position
+            if (at + 1 < length) {
+                text[at] = '<';
+                text[at + 1] = '>';
+                CHECK(validate_brackets(text).valid);
+                check_text(text);
+                text[at + 1] = ']';
+                CHECK(!validate_brackets(text).valid);
+                check_text(text);
+            }
+        }
+    }
+}
+
+static void test_depth_limit() {
+    std::string deepest = std::string(MAX_BRACKET_DEPTH, '(') + std::string(MAX_BRACKET_DEPTH, ')');
+    CHECK(validate_brackets(deepest).valid);
+    check_text(deepest);
+
+    // One more opener: rejected at it, even though the text balances
+    for (size_t prefix : {0, 5, 31, 32, 40}) {
+        std::string text = std::string(prefix, '.') + std::string(MAX_BRACKET_DEPTH + 1, '{') +
+                           std::string(MAX_BRACKET_DEPTH + 1, '}');
+        BracketValidation result = validate_brackets(text);
+        CHECK(!result.valid);
+        CHECK(result.depth_exceeded);
+        CHECK(result.error_offset == prefix + MAX_BRACKET_DEPTH);
+        check_text(text);
+    }
+
+    // Depth is what counts, not the number of brackets
+    std::string wide;
+    for (int i = 0; i < 5000; i++) wide += "([])";
+    CHECK(validate_brackets(wide).valid);
+    check_text(wide);
+}
+
+int main() {
+    std::cout << "AVX2 kernel " << (cpu_has_avx2() ? "enabled" : "not available") << "\n";
+    test_random();
+    test_tails();
+    test_depth_limit();
+    return test_result();
+}
@@ -0,0 +1,130 @@
+#include "check.hpp"
+#include "chat_analyzer.hpp"
+#include "text_normalizer.hpp"
+#include <cstdio>
+#include <fstream>
+#include <sstream>
+#include <string>
+#include <thread>
+#include <vector>
+
+#ifndef _WIN32
+#include <unistd.h>
+#endif
+
+// ChatLogAnalyzer reports a mapped file and the same log read from a pipe
+// (through LineSource's buffer) identically; short lines must survive their
+// batch being handed from the reader to a worker. Its workers report from
+// analyze_batch(), which must agree with analyze_message().
+
+static std::string sample_log() {
+    const char* lines[] = {"hi", "yo", "you idiot", "ok", "(fine) [thanks]", "",
+                           "what a stupid moron, honestly", "x"};
+    std::string log;
+    for (int i = 0; i < 200; i++) {
+        log += lines[i % 8];
+        log += '\n';
+    }
+    return log;
+}
+
+static std::string report(const std::string& path, unsigned workers) {
+    std::ostringstream out;
+    std::streambuf* saved = std::cout.rdbuf(out.rdbuf());
+    ChatLogAnalyzer().analyze_file(path, workers);
+    std::cout.rdbuf(saved);
+    return out.str();
+}
+
+#ifndef _WIN32
+static std::string report_from_pipe(const std::string& log, unsigned workers) {
+    int fds[2];
+    if (pipe(fds) != 0) {
+        CHECK(false);
+        return "";
+    }
+    // The log fits in the pipe buffer, so the writer never waits on the reader
+    std::thread writer([&] {
+        size_t done = 0;
+        while (done < log.size()) {
+            ssize_t n = write(fds[1], log.data() + done, log.size() - done);
+            if (n <= 0) break;
+            done += static_cast<size_t>(n);
+        }
+        close(fds[1]);
+    });
+    std::string out = report("/dev/fd/" + std::to_string(fds[0]), workers);
+    writer.join();
+    close(fds[0]);
+    return out;
+}
+#endif
+
+// Writes log to a regular file and checks the pipe against it
+static void check_pipe_matches_file(const std::string& log, const std::string& first, const std::string& last) {
+    const std::string path = "chat_analyzer_test.log";
+    {
+        std::ofstream file(path, std::ios::binary);
+        file << log;
+    }
+
+    for (unsigned workers : {1u, 4u}) {
+        std::string expected = report(path, workers);
+        CHECK(expected.find(first) != std::string::npos);
+        CHECK(expected.find(last) != std::string::npos);
+#ifndef _WIN32
+        CHECK(report_from_pipe(log, workers) == expected);
+#endif
+    }
+    std::remove(path.c_str());
+}
+
+static void test_pipe_matches_file() {
+    check_pipe_matches_file(sample_log(), "Message 1:\033[0m hi\n", "Message 200:\033[0m x\n");
+    // A batch short enough for std::string's inline buffer
+    check_pipe_matches_file("hi\nyo\n", "Message 1:\033[0m hi\n", "Message 2:\033[0m yo\n");
+}
+
+// The worker's view of a batch: words recovered by normalizing their spans
+static void test_batch_matches_messages() {
+    std::vector<std::string_view> messages = {"hi", "you idiot", "ID10T!! so dumb", "stup1d (trash] <x>",
+                                              "", "((deep [nesting] {ok}))", "*bold* dumb idiot stupid"};
+    ToxicityAnalyzer analyzer(false);
+    ToxicityAnalyzer::BatchResults results;
+    analyzer.analyze_batch(messages, results);
+    CHECK(results.size() == messages.size());
+
+    for (size_t i = 0; i < messages.size() && i < results.size(); i++) {
+        auto expected = analyzer.analyze_message(messages[i]);
+        CHECK(results.scores[i] == expected.toxicity_score);
+        CHECK((results.valid_structure[i] != 0) == expected.valid_structure);
+        CHECK(results.exact_counts[i] == expected.exact_matches.size());
+        CHECK(results.approx_counts[i] == expected.approx_matches.size());
+        if (results.exact_counts[i] != expected.exact_matches.size() ||
+            results.approx_counts[i] != expected.approx_matches.size()) {
+            continue;
+        }
+
+        size_t m = results.match_begin[i];
+        for (const auto& match : expected.exact_matches) {
+            CHECK(analyzer.pattern_names()[results.match_pattern_ids[m]] == match.word);
+            m++;
+        }
+        for (const auto& match : expected.approx_matches) {
+            std::string_view source = messages[i].substr(results.match_offsets[m], results.match_lengths[m]);
+            std::string word(source.size(), '\0');
+            word.resize(normalize_text(source, word.data()));
+            CHECK(word == match.original);
+            CHECK(analyzer.pattern_names()[results.match_pattern_ids[m]] == match.matched_pattern);
+            CHECK(results.match_distances[m] == match.distance);
+            m++;
+        }
+        CHECK(m == results.match_begin[i + 1]);
+    }
+}
+
+int main() {
+    test_pipe_matches_file();
+    test_batch_matches_messages();
+    return test_result();
+}
@@ -0,0 +1,31 @@
+#ifndef CHECK_HPP
+#define CHECK_HPP
+
+#include <cstdlib>
+#include <iostream>
+
+// Minimal assertions for the test executables: CHECK reports and counts a
+// failure, test_result() turns the count into the exit status.
+inline int& check_failures() {
+    static int failures = 0;
+    return failures;
+}
+
+#define CHECK(condition)                                                                \
+    do {                                                                                \
+        if (!(condition)) {                                                             \
+            std::cerr << __FILE__ << ":" << __LINE__ << ": CHECK failed: " #condition "\n"; \
+            check_failures()++;                                                         \
+        }                                                                               \
+    } while (0)
+
+inline int test_result() {
+    if (check_failures() == 0) {
+        std::cout << "OK\n";
+        return EXIT_SUCCESS;
+    }
+    std::cerr << check_failures() << " check(s) failed\n";
+    return EXIT_FAILURE;
+}
+
+#endif // CHECK_HPP
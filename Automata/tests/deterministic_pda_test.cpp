@@ -0,0 +1,97 @@
+#include "check.hpp"
+#include "deterministic_pda.hpp"
+#include "pda_engine.hpp"
+#include "pda_runner.hpp"
+#include <random>
+#include <string>
+#include <vector>
+
+// DeterministicPDA on the two deterministic built-ins, against the
+// hand-written PDA checks and against PDARunner on the same tables
+
+// The closers PDA::simulate() skips: those that do not match the open
+// bracket on top. Without them, its answer is the balanced-bracket PDA's.
+static std::string without_skipped_closers(const std::string& text) {
+    const std::string openers = "([{<", closers = ")]}>";
+    std::string stack, kept;
+    for (char c : text) {
+        if (openers.find(c) != std::string::npos) {
+            stack += c;
+        } else if (size_t b = closers.find(c); b != std::string::npos) {
+            if (stack.empty() || stack.back() != openers[b]) continue;
+            stack.pop_back();
+        }
+        kept += c;
+    }
+    return kept;
+}
+
+static void test_compiles() {
+    PDA brackets = BracketPDA::create_balanced_bracket_pda();
+    PDA markdown = BracketPDA::create_markdown_pda();
+    CHECK(DeterministicPDA(brackets).is_compiled());
+    CHECK(DeterministicPDA(markdown).is_compiled());
+    CHECK(DeterministicPDA(BracketPDA::create_markdown_pda(false)).is_compiled());
+
+    // Epsilon moves compete with input moves: left to PDARunner
+    DeterministicPDA toxic(BracketPDA::create_toxic_detection_pda({"hate"}));
+    CHECK(!toxic.is_compiled());
+    CHECK(!toxic.error().empty());
+    CHECK(!toxic.accepts(""));
+}
+
+static void test_balanced_brackets() {
+    PDA pda = BracketPDA::create_balanced_bracket_pda();
+    DeterministicPDA dpda(pda);
+    PDARunner runner(pda);
+    std::mt19937 rng(25);
+    const std::string alphabet = "()[]{}<>a ";
+    for (int round = 0; round < 20000; round++) {
+        std::string text(rng() % 40, 'a');
+        for (char& c : text) c = alphabet[rng() % alphabet.size()];
+
+        CHECK(dpda.accepts(without_skipped_closers(text)) == pda.simulate(text));
+        PDARunner::Result compiled = dpda.run(text), table = runner.run(text);
+        CHECK(compiled.accepted == table.accepted);
+        CHECK(compiled.reject_offset == table.reject_offset);
+        if (compiled.accepted) CHECK(pda.simulate(text));
+    }
+}
+
+static void test_markdown() {
+    PDA pda = BracketPDA::create_markdown_pda();
+    DeterministicPDA dpda(pda), loose(BracketPDA::create_markdown_pda(false));
+    PDARunner runner(pda);
+    std::mt19937 rng(26);
+    const std::string alphabet = "()[]{}<>**~~a _";
+    for (int round = 0; round < 20000; round++) {
+        std::string text(rng() % 40, 'a');
+        for (char& c : text) c = round % 2 ? alphabet[rng() % alphabet.size()] : "*~(a)"[rng() % 5];
+
+        std::vector<std::pair<int, int>> errors;
+        std::string message;
+        bool valid = pda.simulate_markdown(text, errors, message);
+        PDARunner::Result compiled = dpda.run(text), table = runner.run(text);
+        CHECK(compiled.accepted == valid);
+        CHECK(table.accepted == valid);
+        CHECK(compiled.reject_offset == table.reject_offset);
+        if (valid) CHECK(loose.accepts(text));  // Non-strict nesting only relaxes
+    }
+}
+
+static void test_depth_limit() {
+    DeterministicPDA dpda(BracketPDA::create_balanced_bracket_pda());
+    std::string deep = std::string(100, '(') + std::string(100, ')');
+    CHECK(dpda.accepts(deep));
+    PDARunner::Result result = dpda.run(deep, 50);
+    CHECK(!result.accepted);
+    CHECK(result.limit_hit);
+}
+
+int main() {
+    test_compiles();
+    test_balanced_brackets();
+    test_markdown();
+    test_depth_limit();
+    return test_result();
+}
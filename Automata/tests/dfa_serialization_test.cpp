@@ -0,0 +1,201 @@
+#include "check.hpp"
+#include "blocklist.hpp"
+#include "dfa_serialization.hpp"
+#include "nfa_engine.hpp"
+#include "toxicity_analyzer.hpp"
+#include <algorithm>
+#include <chrono>
+#include <cstddef>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <iterator>
+#include <random>
+#include <string>
+#include <vector>
+
+namespace fs = std::filesystem;
+
+static fs::path scratch_dir;
+
+static std::string temp_file(const std::string& name) {
+    return (scratch_dir / name).string();
+}
+
+static std::string read_file(const std::string& path) {
+    std::ifstream in(path, std::ios::binary);
+    return std::string(std::istreambuf_iterator<char>(in), {});
+}
+
+static void write_file(const std::string& path, const std::string& bytes) {
+    std::ofstream(path, std::ios::binary | std::ios::trunc).write(bytes.data(), static_cast<std::streamsize>(bytes.size()));
+}
+
+// ==================== ROUND TRIP ====================
+
+static void check_round_trip(DFA& dfa, const std::string& path, const std::string& alphabet) {
+    CHECK(save_compiled_dfa(dfa, path));
+    MappedDFA mapped(path);
+    CHECK(mapped.is_loaded());
+    CHECK(mapped.verify());
+    CHECK(mapped.get_start_state() == dfa.get_start_state());
+    CHECK(mapped.get_num_states() == static_cast<int>(dfa.get_accepting().size()));
+
+    std::mt19937 rng(20);
+    for (int round = 0; round < 2000; round++) {
+        std::string text(rng() % 10, 'a');
+        for (char& c : text) c = alphabet[rng() % alphabet.size()];
+        CHECK(mapped.simulate(text) == dfa.simulate(text));
+    }
+}
+
+static void test_round_trip() {
+    DFA regex = convert_nfa_to_dfa(RegexToNFA::from_regex("(ab|ba)*c?(d|.a)"));
+    minimize(regex);
+    check_round_trip(regex, temp_file("regex.adfa"), "abcdx");
+
+    std::vector<std::string> words = {"idiot", "idiots", "hate", "hat", "moron", "stupid", "hate"};
+    DFA lexicon = build_lexicon_dfa(words);
+    std::string path = temp_file("lexicon.adfa");
+    check_round_trip(lexicon, path, "idotshaemrnup");
+
+    // Word ids come back through the outputs, duplicates included
+    MappedDFA mapped(path);
+    auto outputs_of = [&](const std::string& word) {
+        std::vector<int> ids;
+        int state = mapped.get_start_state();
+        for (char c : word) {
+            if (state < 0) break;
+            state = mapped.next_state(state, static_cast<unsigned char>(c));
+        }
+        if (state >= 0) mapped.for_each_output(state, [&](int id) { ids.push_back(id); });
+        return ids;
+    };
+    CHECK(outputs_of("hat") == std::vector<int>{3});
+    CHECK(outputs_of("idiots") == std::vector<int>{1});
+    std::vector<int> hate = outputs_of("hate");
+    std::sort(hate.begin(), hate.end());
+    CHECK(hate == (std::vector<int>{2, 6}));
+    CHECK(outputs_of("ha").empty());
+
+    // Saving over a mapped file leaves the old mapping intact
+    DFA other = build_lexicon_dfa({"zzz"});
+    CHECK(save_compiled_dfa(other, path));
+    CHECK(mapped.simulate("moron"));
+    CHECK(MappedDFA(path).simulate("zzz"));
+}
+
+// ==================== DAMAGED FILES ====================
+
+static void test_damaged_files() {
+    DFA dfa = build_lexicon_dfa({"alpha", "beta", "gamma"});
+    std::string good_path = temp_file("good.adfa");
+    CHECK(save_compiled_dfa(dfa, good_path));
+    const std::string good = read_file(good_path);
+    DFAFileHeader header;
+    std::memcpy(&header, good.data(), sizeof(header));
+
+    auto load = [&](const std::string& bytes) {
+        std::string path = temp_file("damaged.adfa");
+        write_file(path, bytes);
+        return MappedDFA(path);
+    };
+
+    CHECK(!MappedDFA(temp_file("missing.adfa")).is_loaded());
+
+    // Truncated anywhere: in the header, or past it (size mismatch)
+    for (size_t length : {size_t{0}, size_t{7}, sizeof(DFAFileHeader) - 1, sizeof(DFAFileHeader),
+                          good.size() / 2, good.size() - 1}) {
+        MappedDFA truncated = load(good.substr(0, length));
+        CHECK(!truncated.is_loaded());
+        CHECK(!truncated.verify());
+        CHECK(!truncated.simulate("alpha"));
+    }
+    CHECK(!load(good + std::string(8, '\0')).is_loaded());
+
+    auto patched = [&](size_t offset, const void* value, size_t size) {
+        std::string bytes = good;
+        std::memcpy(bytes.data() + offset, value, size);
+        return bytes;
+    };
+    CHECK(load(patched(0, "NOTADFA", 8)).error() == "not a compiled DFA file");
+    std::uint32_t version = DFAFileHeader::VERSION + 1;
+    CHECK(!load(patched(offsetof(DFAFileHeader, version), &version, 4)).is_loaded());
+    std::uint32_t swapped = 0x04030201;
+    CHECK(!load(patched(offsetof(DFAFileHeader, byte_order), &swapped, 4)).is_loaded());
+    std::int32_t bad_start = static_cast<std::int32_t>(header.num_states);
+    CHECK(!load(patched(offsetof(DFAFileHeader, start_state), &bad_start, 4)).is_loaded());
+    std::uint64_t bad_offset = header.file_size;
+    CHECK(!load(patched(offsetof(DFAFileHeader, table_offset), &bad_offset, 8)).is_loaded());
+    std::uint8_t bad_class = static_cast<std::uint8_t>(header.num_classes);
+    CHECK(load(patched(header.byte_class_offset + 'a', &bad_class, 1)).error() == "byte class out of range");
+
+    // A bad table entry passes the constant-time load but not verify()
+    std::int32_t bad_target = static_cast<std::int32_t>(header.num_states);
+    MappedDFA bad_table = load(patched(header.table_offset, &bad_target, 4));
+    CHECK(bad_table.is_loaded());
+    CHECK(!bad_table.verify());
+    std::uint32_t bad_end = header.num_outputs + 1;
+    MappedDFA bad_outputs = load(patched(header.output_begin_offset + header.num_states * 4, &bad_end, 4));
+    CHECK(bad_outputs.is_loaded());
+    CHECK(!bad_outputs.verify());
+}
+
+// ==================== BLOCKLIST ====================
+
+static void test_blocklist() {
+    std::string list = temp_file("blocklist.txt");
+    write_file(list, "# custom words\r\nScumbag\r\n\r\n  clown  \nno-good\n");
+    std::string error;
+    auto blocklist = Blocklist::load(list, error);
+    CHECK(blocklist != nullptr);
+    if (!blocklist) return;
+    CHECK(fs::exists(Blocklist::cache_path(list)));
+    CHECK(blocklist->words() == (std::vector<std::string>{"Scumbag", "clown", "no-good"}));
+    CHECK(blocklist->match("SCUMBAG!") == 0);
+    CHECK(blocklist->match("clown") == 1);
+    CHECK(blocklist->match("nogood") == 2);
+    CHECK(blocklist->match("clowns") == -1);
+    CHECK(blocklist->match("") == -1);
+
+    // A fresh cache is mapped, not rebuilt
+    auto cache_time = fs::last_write_time(Blocklist::cache_path(list));
+    CHECK(Blocklist::load(list, error) != nullptr);
+    CHECK(fs::last_write_time(Blocklist::cache_path(list)) == cache_time);
+
+    // An edited list rebuilds it
+    write_file(list, "clown\nbuffoon\n");
+    fs::last_write_time(list, cache_time + std::chrono::seconds(5));
+    auto edited = Blocklist::load(list, error);
+    CHECK(edited != nullptr && edited->match("buffoon") == 1 && edited->match("scumbag") == -1);
+
+    // So does a damaged cache
+    write_file(Blocklist::cache_path(list), "garbage");
+    fs::last_write_time(Blocklist::cache_path(list), cache_time + std::chrono::seconds(10));
+    auto repaired = Blocklist::load(list, error);
+    CHECK(repaired != nullptr && repaired->match("buffoon") == 1);
+
+    CHECK(Blocklist::load(temp_file("no_such_list.txt"), error) == nullptr);
+    CHECK(!error.empty());
+
+    // Analyzer: blocklist words score as exact matches after the built-in ones
+    ToxicityAnalyzer analyzer(false, blocklist);
+    auto result = analyzer.analyze_message("what a clown, you idiot");
+    CHECK(result.exact_matches.size() == 2);
+    if (result.exact_matches.size() == 2) {
+        CHECK(result.exact_matches[0].word == "clown");
+        CHECK(result.exact_matches[1].word == "idiot");
+    }
+    ToxicityAnalyzer plain(false);
+    CHECK(plain.analyze_message("what a clown, you idiot").exact_matches.size() == 1);
+}
+
+int main() {
+    scratch_dir = fs::temp_directory_path() / ("dfa_serialization_test_" + std::to_string(std::random_device{}()));
+    fs::create_directories(scratch_dir);
+    test_round_trip();
+    test_damaged_files();
+    test_blocklist();
+    fs::remove_all(scratch_dir);
+    return test_result();
+}
@@ -0,0 +1,80 @@
+#include "check.hpp"
+#include "cpu_features.hpp"
+#include "edit_distance.hpp"
+#include <algorithm>
+#include <cctype>
+#include <memory>
+#include <random>
+#include <string>
+#include <vector>
+
+// Myers' bit-parallel distance, scalar and batched (AVX2 when available),
+// against the textbook DP matrix
+
+static int dp_distance(const std::string& pattern, const std::string& text) {
+    std::vector<int> row(text.size() + 1);
+    for (size_t j = 0; j <= text.size(); j++) row[j] = static_cast<int>(j);
+    for (size_t i = 1; i <= pattern.size(); i++) {
+        int diagonal = row[0];
+        row[0] = static_cast<int>(i);
+        for (size_t j = 1; j <= text.size(); j++) {
+            bool same = std::tolower(static_cast<unsigned char>(pattern[i - 1])) ==
+                        std::tolower(static_cast<unsigned char>(text[j - 1]));
+            int next = std::min({row[j] + 1, row[j - 1] + 1, diagonal + (same ? 0 : 1)});
+            diagonal = row[j];
+            row[j] = next;
+        }
+    }
+    return row[text.size()];
+}
+
+static std::mt19937 rng(9);
+
+static std::string random_string(size_t length) {
+    std::string s(length, 'a');
+    for (char& c : s) c = "abcABC-"[rng() % 7];
+    return s;
+}
+
+static void test_scalar() {
+    for (int round = 0; round < 2000; round++) {
+        std::string pattern = random_string(rng() % (MyersPattern::MAX_LENGTH + 1));
+        std::string text = random_string(rng() % 80);
+        CHECK(myers_distance(MyersPattern(pattern), text) == dp_distance(pattern, text));
+    }
+    // Full 64-bit columns: the last bit is the sign bit
+    std::string full(MyersPattern::MAX_LENGTH, 'a');
+    CHECK(myers_distance(MyersPattern(full), full) == 0);
+    CHECK(myers_distance(MyersPattern(full), "") == 64);
+    CHECK(myers_distance(MyersPattern(full), std::string(64, 'B')) == 64);
+}
+
+static void test_batch() {
+    for (int round = 0; round < 300; round++) {
+        // 1 .. 13 patterns: full AVX2 groups of four plus a scalar tail
+        size_t count = 1 + rng() % 13;
+        std::vector<std::string> words;
+        std::vector<std::unique_ptr<MyersPattern>> compiled;
+        std::vector<const MyersPattern*> patterns;
+        for (size_t i = 0; i < count; i++) {
+            words.push_back(random_string(rng() % (MyersPattern::MAX_LENGTH + 1)));
+            compiled.push_back(std::make_unique<MyersPattern>(words.back()));
+            patterns.push_back(compiled.back().get());
+        }
+        std::string text = random_string(rng() % 80);
+
+        std::vector<int> distances(count, -1);
+        myers_distance_batch(patterns.data(), count, text, distances.data());
+        for (size_t i = 0; i < count; i++) {
+            CHECK(distances[i] == dp_distance(words[i], text));
+            CHECK(distances[i] == myers_distance(*patterns[i], text));
+        }
+    }
+}
+
+int main() {
+    std::cout << "AVX2 kernel " << (cpu_has_avx2() ? "enabled" : "not available") << "\n";
+    test_scalar();
+    test_batch();
+    return test_result();
+}
@@ -0,0 +1,149 @@
+#include "check.hpp"
+#include "dfa_engine.hpp"
+#include "lazy_dfa.hpp"
+#include "nfa_engine.hpp"
+#include <algorithm>
+#include <chrono>
+#include <random>
+#include <string>
+#include <thread>
+#include <utility>
+#include <vector>
+
+using Spans = std::vector<std::pair<int, int>>;
+
+// Leftmost-longest, non-overlapping, non-empty spans by trying every
+// substring against the anchored DFA
+static Spans reference_spans(const DFA& dfa, const std::string& text) {
+    Spans spans;
+    int n = static_cast<int>(text.size());
+    for (int start = 0; start < n;) {
+        int end = -1;
+        for (int e = n; e > start && end < 0; e--) {
+            if (dfa.simulate(std::string_view(text).substr(start, e - start))) end = e;
+        }
+        if (end < 0) {
+            start++;
+            continue;
+        }
+        spans.push_back({start, end});
+        start = end;
+    }
+    return spans;
+}
+
+static DFA compile_regex(const std::string& regex) {
+    DFA dfa = convert_nfa_to_dfa(RegexToNFA::from_regex(regex));
+    minimize(dfa);
+    return dfa;
+}
+
+// Best of a few runs, in seconds
+template <typename F>
+static double time_of(F&& f) {
+    double best = 1e9;
+    for (int run = 0; run < 3; run++) {
+        auto t0 = std::chrono::steady_clock::now();
+        f();
+        best = std::min(best, std::chrono::duration<double>(std::chrono::steady_clock::now() - t0).count());
+    }
+    return best;
+}
+
+// ==================== SPANS ====================
+
+static void test_spans() {
+    const char* patterns[] = {"a*c|b", "ab*", "(a|ab)(c|bcd)", "a+b+", "(idiot|stupid|hate)", "(ab|ba)*c?", "d.d"};
+    std::mt19937 rng(7);
+    for (const char* pattern : patterns) {
+        DFA dfa = compile_regex(pattern);
+        NFA source = RegexToNFA::from_regex(pattern);
+        BitParallelNFA nfa(source);
+        LazyDFA lazy(source);
+        LazyDFA tiny(source, 0);  // Cleared on almost every new state
+        for (int round = 0; round < 300; round++) {
+            std::string text(rng() % 24, 'a');
+            for (char& c : text) c = "abcd"[rng() % 4];
+            Spans expected = reference_spans(dfa, text);
+            CHECK(dfa.find_all(text) == expected);
+            CHECK(nfa.find_all(text) == expected);
+            CHECK(lazy.find_all(text) == expected);
+            CHECK(tiny.find_all(text) == expected);
+        }
+    }
+
+    DFA lexicon = compile_regex("(idiot|stupid|hate)");
+    CHECK(lexicon.find_all("you idiot, I hate stupid idiots") == (Spans{{4, 9}, {13, 17}, {18, 24}, {25, 30}}));
+    CHECK(lexicon.find_all("").empty());
+
+    // A pattern matching only the empty string reports nothing
+    CHECK(compile_regex("a*").find_all("bbb").empty());
+}
+
+// ==================== LINEAR SCALING ====================
+
+// "aaaa...b" against "a*c|b": every 'a' starts a run that only dies at the
+// final 'b', so trying each start with a longest-match scan is quadratic
+template <typename Engine>
+static void check_linear_scaling(Engine&& engine, size_t n) {
+    auto adversarial = [](size_t length) { return std::string(length - 1, 'a') + 'b'; };
+    std::string small = adversarial(n), large = adversarial(4 * n);
+    CHECK(engine.find_all(small) == (Spans{{static_cast<int>(n - 1), static_cast<int>(n)}}));
+    CHECK(engine.find_all(large) == (Spans{{static_cast<int>(4 * n - 1), static_cast<int>(4 * n)}}));
+
+    double t_small = time_of([&] { engine.find_all(small); });
+    double t_large = time_of([&] { engine.find_all(large); });
+    // Linear: about 4x. Quadratic would be 16x.
+    CHECK(t_large < 8 * t_small + 0.005);
+}
+
+static void test_linear_scaling() {
+    check_linear_scaling(compile_regex("a*c|b"), 200000);
+    check_linear_scaling(BitParallelNFA(RegexToNFA::from_regex("a*c|b")), 50000);
+    check_linear_scaling(LazyDFA(RegexToNFA::from_regex("a*c|b")), 200000);
+}
+
+// ==================== SHARED ENGINES ====================
+
+// Threads share a freshly built engine, so its first uses race to build
+// the compiled table and the reverse liveness
+template <typename Engine>
+static void check_shared(const Engine& engine, const std::vector<std::string>& texts, const std::vector<Spans>& expected) {
+    std::vector<std::thread> threads;
+    std::vector<int> failures(4, 0);
+    for (int t = 0; t < 4; t++) {
+        threads.emplace_back([&, t] {
+            for (size_t i = 0; i < texts.size(); i++) {
+                size_t k = (i + static_cast<size_t>(t)) % texts.size();
+                if (engine.find_all(texts[k]) != expected[k]) failures[t]++;
+            }
+        });
+    }
+    for (std::thread& thread : threads) thread.join();
+    for (int count : failures) CHECK(count == 0);
+}
+
+static void test_shared_engines() {
+    std::mt19937 rng(13);
+    std::vector<std::string> texts(64);
+    for (std::string& text : texts) {
+        text.assign(rng() % 64, 'a');
+        for (char& c : text) c = "abcd"[rng() % 4];
+    }
+    for (int round = 0; round < 20; round++) {
+        NFA nfa = RegexToNFA::from_regex("(a|ab)(c|bcd)|a*c|b");
+        const DFA reference = compile_regex("(a|ab)(c|bcd)|a*c|b");
+        std::vector<Spans> expected;
+        for (const std::string& text : texts) expected.push_back(reference_spans(reference, text));
+
+        check_shared(convert_nfa_to_dfa(nfa), texts, expected);
+        check_shared(BitParallelNFA(nfa), texts, expected);
+    }
+}
+
+int main() {
+    test_spans();
+    test_linear_scaling();
+    test_shared_engines();
+    return test_result();
+}
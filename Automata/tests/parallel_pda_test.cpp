@@ -0,0 +1,83 @@
+#include "check.hpp"
+#include "parallel_pda.hpp"
+#include "pda_engine.hpp"
+#include "toxicity_analyzer.hpp"
+#include <random>
+#include <string>
+#include <vector>
+
+// ParallelPDA against the sequential PDA methods, at chunk sizes small
+// enough that every bracket and marker pattern spans chunk boundaries
+
+static void test_random() {
+    std::mt19937 rng(22);
+    PDA pda;
+    WorkStealingPool pool(3);
+    const std::string alphabet = "()[]{}<>**~~a _";
+    for (int round = 0; round < 20000; round++) {
+        std::string text(rng() % 80, 'a');
+        int mode = static_cast<int>(rng() % 3);
+        for (char& c : text) {
+            if (mode == 0) c = alphabet[rng() % alphabet.size()];
+            else if (mode == 1) c = "(*)*"[rng() % 4];
+            else c = "*[]~"[rng() % 4];
+        }
+        size_t chunk = 1 + rng() % 9;
+
+        BracketValidation parallel = ParallelPDA::simulate(text, chunk, pool);
+        BracketValidation sequential = validate_brackets(text);
+        CHECK(parallel.valid == pda.simulate(text));
+        CHECK(parallel.valid == sequential.valid);
+        CHECK(parallel.error_offset == sequential.error_offset);
+
+        std::vector<std::pair<int, int>> expected_errors, errors;
+        std::string expected_message, message;
+        bool expected = pda.simulate_markdown(text, expected_errors, expected_message);
+        CHECK(ParallelPDA::simulate_markdown(text, errors, message, chunk, pool) == expected);
+        CHECK(errors == expected_errors);
+        CHECK(message == expected_message);
+    }
+}
+
+static void test_large() {
+    PDA pda;
+    WorkStealingPool pool(4);
+    std::string big;
+    const std::string pattern = "ab(c)[d*e*]**f** {g}<h>";
+    for (size_t i = 0; i < 3000000; i++) big += pattern[i % pattern.size()];
+    for (size_t chunk : {size_t{4096}, size_t{1} << 20}) {
+        CHECK(ParallelPDA::simulate(big, chunk, pool).valid == pda.simulate(big));
+        big.insert(big.size() / 2, "(");
+        CHECK(ParallelPDA::simulate(big, chunk, pool).valid == pda.simulate(big));
+        big.erase(big.size() / 2, 1);
+
+        std::vector<std::pair<int, int>> expected_errors, errors;
+        std::string expected_message, message;
+        bool expected = pda.simulate_markdown(big, expected_errors, expected_message);
+        CHECK(ParallelPDA::simulate_markdown(big, errors, message, chunk, pool) == expected);
+        CHECK(errors == expected_errors);
+    }
+}
+
+// The parallel summaries have no depth limit, validate_brackets() has
+// one; the analyzer must answer the same for short and huge messages
+static void test_depth_rule() {
+    std::string deep = std::string(3 * MAX_BRACKET_DEPTH, '(') + std::string(3 * MAX_BRACKET_DEPTH, ')');
+    CHECK(validate_brackets(deep).depth_exceeded);
+    CHECK(ParallelPDA::simulate(deep).valid);
+
+    ToxicityAnalyzer analyzer(false);
+    CHECK(analyzer.analyze_message(deep).valid_structure);
+    CHECK(!analyzer.analyze_message(deep + "[").valid_structure);
+
+    std::string huge = deep + std::string(4 * ParallelPDA::DEFAULT_CHUNK_BYTES, '.');
+    CHECK(analyzer.analyze_message(huge).valid_structure);
+    CHECK(!analyzer.analyze_message(huge + "[").valid_structure);
+}
+
+int main() {
+    test_random();
+    test_large();
+    test_depth_rule();
+    return test_result();
+}
@@ -0,0 +1,147 @@
+#include "check.hpp"
+#include "pda_engine.hpp"
+#include "pda_runner.hpp"
+#include <random>
+#include <string>
+#include <vector>
+
+// PDARunner on hand-built tables with known languages, and on the
+// built-in PDAs against their hand-written checks
+
+// Balanced brackets where, unlike PDA::simulate(), a stray closer rejects
+static bool balanced(const std::string& text) {
+    const std::string openers = "([{<", closers = ")]}>";
+    std::string stack;
+    for (char c : text) {
+        if (openers.find(c) != std::string::npos) {
+            stack += c;
+        } else if (size_t b = closers.find(c); b != std::string::npos) {
+            if (stack.empty() || stack.back() != openers[b]) return false;
+            stack.pop_back();
+        }
+    }
+    return stack.empty();
+}
+
+static void test_accept_reject() {
+    // a^n b^n
+    PDA pda;
+    int p = pda.add_node(false), q = pda.add_node(false), f = pda.add_node(true);
+    pda.set_start_state(p);
+    pda.add_transition(p, p, 'a', 0, "A");
+    pda.add_transition(p, q, 'b', 'A', "");
+    pda.add_transition(q, q, 'b', 'A', "");
+    pda.add_transition(p, f, 0, '$', "$");
+    pda.add_transition(q, f, 0, '$', "$");
+    PDARunner runner(pda);
+
+    for (const char* accepted : {"", "ab", "aaabbb"}) CHECK(runner.accepts(accepted));
+    for (const char* rejected : {"a", "aab", "abb", "ba", "abab"}) CHECK(!runner.accepts(rejected));
+
+    PDARunner::Result result = runner.run("abba");
+    CHECK(!result.accepted);
+    CHECK(!result.limit_hit);
+    CHECK(result.reject_offset == 2);   // No move for the second 'b'
+    result = runner.run("aab");
+    CHECK(!result.accepted);
+    CHECK(result.reject_offset == 3);   // Whole input read, no final state
+}
+
+static void test_nondeterminism() {
+    // Even palindromes over {a, b}: every position is a guess at the middle
+    PDA pda;
+    int push = pda.add_node(false), pop = pda.add_node(false), done = pda.add_node(true);
+    pda.set_start_state(push);
+    for (char c : {'a', 'b'}) {
+        pda.add_transition(push, push, c, 0, std::string(1, c));
+        pda.add_transition(pop, pop, c, c, "");
+    }
+    pda.add_transition(push, pop, 0, 0, "");
+    pda.add_transition(pop, done, 0, '$', "$");
+    PDARunner runner(pda);
+
+    std::mt19937 rng(24);
+    for (int round = 0; round < 5000; round++) {
+        std::string word(rng() % 14, 'a');
+        for (char& c : word) c = "ab"[rng() % 2];
+        if (round % 2) word += std::string(word.rbegin(), word.rend());
+        bool palindrome = word.size() % 2 == 0 && std::string(word.rbegin(), word.rend()) == word;
+        PDARunner::Result result = runner.run(word);
+        CHECK(result.accepted == palindrome);
+        CHECK(!result.limit_hit);
+    }
+
+    // Two moves on the same byte, only one of which survives
+    PDA branching;
+    int s = branching.add_node(false), x = branching.add_node(false), y = branching.add_node(true);
+    branching.set_start_state(s);
+    branching.add_transition(s, x, 'a', 0, "");
+    branching.add_transition(s, y, 'a', 0, "");
+    branching.add_transition(x, x, 'b', 0, "");
+    branching.add_transition(y, y, 'c', 0, "");
+    PDARunner branches(branching);
+    CHECK(!branches.accepts("ab"));
+    CHECK(branches.accepts("acc"));
+    CHECK(branches.run("abc").reject_offset == 2);
+}
+
+static void test_epsilon_cycles() {
+    // A cycle that leaves the stack alone closes without hitting a bound
+    PDA cycle;
+    int a = cycle.add_node(false), b = cycle.add_node(false), f = cycle.add_node(true);
+    cycle.set_start_state(a);
+    cycle.add_transition(a, b, 0, 0, "");
+    cycle.add_transition(b, a, 0, 0, "");
+    cycle.add_transition(b, f, 'x', 0, "");
+    cycle.add_transition(f, a, 0, 0, "");
+    PDARunner::Result result = PDARunner(cycle).run("xxx");
+    CHECK(result.accepted);
+    CHECK(!result.limit_hit);
+
+    // A cycle that pushes is cut at the depth bound, and says so
+    PDA growing;
+    int g = growing.add_node(false), h = growing.add_node(true);
+    growing.set_start_state(g);
+    growing.add_transition(g, g, 0, 0, "X");
+    growing.add_transition(g, h, 'y', 'X', "");
+    growing.add_transition(h, h, 'y', 'X', "");
+    PDARunner runner(growing);
+    result = runner.run("yyy", {64, PDARunner::DEFAULT_MAX_CONFIGURATIONS});
+    CHECK(result.accepted);
+    CHECK(result.limit_hit);
+    result = runner.run(std::string(100, 'y'), {64, PDARunner::DEFAULT_MAX_CONFIGURATIONS});
+    CHECK(!result.accepted);  // Needs 100 X's: beyond the bound
+    CHECK(result.limit_hit);
+    result = runner.run(std::string(100, 'y'), {128, PDARunner::DEFAULT_MAX_CONFIGURATIONS});
+    CHECK(result.accepted);
+
+    // ... or at the configuration budget
+    result = runner.run("yyy", {PDARunner::DEFAULT_MAX_DEPTH, 16});
+    CHECK(result.limit_hit);
+    CHECK(result.configurations <= 16 * 4);
+}
+
+static void test_builtins() {
+    PDARunner brackets(BracketPDA::create_balanced_bracket_pda());
+    PDARunner markdown(BracketPDA::create_markdown_pda());
+    PDA pda;
+    std::mt19937 rng(42);
+    const std::string alphabet = "()[]{}<>**~~a _";
+    for (int round = 0; round < 5000; round++) {
+        std::string text(rng() % 30, 'a');
+        for (char& c : text) c = alphabet[rng() % alphabet.size()];
+
+        CHECK(brackets.accepts(text) == balanced(text));
+        std::vector<std::pair<int, int>> errors;
+        std::string message;
+        CHECK(markdown.accepts(text) == pda.simulate_markdown(text, errors, message));
+    }
+}
+
+int main() {
+    test_accept_reject();
+    test_nondeterminism();
+    test_epsilon_cycles();
+    test_builtins();
+    return test_result();
+}
@@ -0,0 +1,161 @@
+#include "check.hpp"
+#include "pda_engine.hpp"
+#include "pda_stream.hpp"
+#include "xml_stream_reader.hpp"
+#include <random>
+#include <string>
+#include <vector>
+
+// PDAStreamState fed in fragments against PDA::simulate_markdown on the
+// whole message
+
+struct Outcome {
+    bool valid;
+    std::vector<std::pair<int, int>> errors;
+    std::string message;
+    bool operator==(const Outcome&) const = default;
+};
+
+static Outcome whole(const std::string& text) {
+    PDA pda;
+    Outcome outcome;
+    outcome.valid = pda.simulate_markdown(text, outcome.errors, outcome.message);
+    return outcome;
+}
+
+static Outcome streamed(const std::vector<std::string_view>& fragments) {
+    PDAStreamState state;
+    for (std::string_view fragment : fragments) state.feed(fragment);
+    Outcome outcome;
+    outcome.valid = state.finish();
+    outcome.errors = state.error_positions();
+    outcome.message = state.error_message();
+    return outcome;
+}
+
+// One split at every point, then one byte at a time
+static void check_all_splits(const std::string& text) {
+    Outcome expected = whole(text);
+    std::string_view view(text);
+    for (size_t split = 0; split <= text.size(); split++) {
+        CHECK(streamed({view.substr(0, split), view.substr(split)}) == expected);
+    }
+    std::vector<std::string_view> bytes;
+    for (size_t i = 0; i < text.size(); i++) bytes.push_back(view.substr(i, 1));
+    CHECK(streamed(bytes) == expected);
+}
+
+static void test_split_points() {
+    const char* messages[] = {
+        "**bold** and *italic* and ~~struck~~",
+        "a*",                  // '*' pending at the end of input
+        "a~",                  // '~' pending at the end of input
+        "*",
+        "~~",
+        "**",
+        "***x***",
+        "~~~x~~~",
+        "*a **b** c*",
+        "**a *b* c**",
+        "**a *b** c*",         // Crossed formatting
+        "(a [b] {c} <d>)",
+        "(a **b) c**",
+        "[*a]*",
+        "~~a (b~~ c)",
+        "unclosed **bold and (paren",
+        "stray ) closer and ] another",
+        "~a~ single tildes ~",
+        "",
+    };
+    for (const char* message : messages) check_all_splits(message);
+}
+
+static void test_random() {
+    std::mt19937 rng(23);
+    const std::string alphabet = "()[]{}<>**~~a *";
+    for (int round = 0; round < 3000; round++) {
+        std::string text(rng() % 40, 'a');
+        for (char& c : text) c = round % 2 ? alphabet[rng() % alphabet.size()] : "*~(a)"[rng() % 5];
+        check_all_splits(text);
+
+        // Many fragments, some empty
+        std::vector<std::string_view> fragments;
+        std::string_view view(text);
+        for (size_t at = 0; at < text.size();) {
+            size_t length = std::min<size_t>(rng() % 5, text.size() - at);
+            fragments.push_back(view.substr(at, length));
+            at += length;
+        }
+        CHECK(streamed(fragments) == whole(text));
+    }
+}
+
+static void test_state() {
+    // A copy is a checkpoint: two continuations from the same prefix
+    PDAStreamState state;
+    CHECK(state.feed("**bold *"));
+    CHECK(state.bytes_fed() == 8);
+    CHECK(state.depth() == 1);  // The bold; the trailing '*' is pending
+    PDAStreamState checkpoint = state;
+    state.feed("*");            // "**" across the copy
+    CHECK(state.finish() == whole("**bold **").valid);
+    checkpoint.feed("x* (rest)");
+    CHECK(checkpoint.finish() == whole("**bold *x* (rest)").valid);
+
+    // Input after an error is ignored
+    PDAStreamState failing;
+    CHECK(!failing.feed("(a]"));
+    CHECK(failing.failed());
+    CHECK(!failing.feed("))))"));
+    CHECK(!failing.finish());
+    Outcome stopped{false, failing.error_positions(), failing.error_message()};
+    CHECK(stopped == whole("(a]))))"));
+
+    // reset() starts a new message
+    failing.reset();
+    CHECK(!failing.failed());
+    CHECK(failing.feed("*ok*"));
+    CHECK(failing.finish());
+}
+
+// The XML analysis feeds each message's text to a PDAStreamState piece by
+// piece as XMLStreamReader reads it; the pieces must add up to the text
+static void test_xml_text_pieces() {
+    const char* texts[] = {"**bold** and *it*", "plain", "(open [x]", "a*", "&lt;b&gt; ~~s~~ *x",
+                           "<![CDATA[**raw*]]>", "<b>tag</b> **"};
+    std::string document = "<log>";
+    for (const char* text : texts) document += std::string("<message><user>u</user><text>") + text + "</text></message>";
+    document += "<text>**standalone</text></log>";
+
+    for (size_t chunk : {size_t{1}, size_t{3}, size_t{7}, document.size()}) {
+        PDAStreamState state;
+        std::string pieces;
+        std::vector<std::string> read;
+        XMLStreamReader reader([&](const XMLChatMessage& message) {
+            CHECK(pieces == message.text);
+            Outcome outcome;
+            outcome.valid = state.finish();
+            outcome.errors = state.error_positions();
+            outcome.message = state.error_message();
+            CHECK(outcome == whole(message.text));
+            read.push_back(message.text);
+            state.reset();
+            pieces.clear();
+        });
+        reader.set_text_callback([&](std::string_view piece) {
+            pieces += piece;
+            state.feed(piece);
+        });
+        for (size_t i = 0; i < document.size(); i += chunk) reader.feed(std::string_view(document).substr(i, chunk));
+        reader.finish();
+        CHECK(read.size() == std::size(texts) + 1);
+    }
+}
+
+int main() {
+    test_split_points();
+    test_random();
+    test_state();
+    test_xml_text_pieces();
+    return test_result();
+}
@@ -0,0 +1,96 @@
+#include "check.hpp"
+#include "dfa_engine.hpp"
+#include "lazy_dfa.hpp"
+#include "nfa_engine.hpp"
+#include "pattern_cache.hpp"
+#include <cctype>
+#include <random>
+#include <regex>
+#include <string>
+#include <utility>
+
+// Random regexes in the syntax RegexToNFA supports, checked for whole-string
+// matching against std::regex (ECMAScript) on random texts: the NFA, the
+// bit-parallel NFA, the lazy DFA, the compiled DFA before and after
+// minimization, and CompiledRegex from the pattern cache.
+
+static std::mt19937 rng(2024);
+
+static std::string random_regex(int depth) {
+    int choice = depth <= 0 ? static_cast<int>(rng() % 2) : static_cast<int>(rng() % 6);
+    switch (choice) {
+        case 0: return std::string(1, "abc"[rng() % 3]);
+        case 1: return rng() % 4 == 0 ? "." : std::string(1, "abc"[rng() % 3]);
+        case 2: return random_regex(depth - 1) + random_regex(depth - 1);
+        case 3: return "(" + random_regex(depth - 1) + "|" + random_regex(depth - 1) + ")";
+        case 4: return "(" + random_regex(depth - 1) + ")" + "*+?"[rng() % 3];
+        default: return random_regex(depth - 1) + random_regex(depth - 1) + random_regex(depth - 1);
+    }
+}
+
+static std::string random_text(const char* alphabet, size_t alphabet_size) {
+    std::string text(rng() % 9, 'a');
+    for (char& c : text) c = alphabet[rng() % alphabet_size];
+    return text;
+}
+
+static void test_engines_agree() {
+    for (int round = 0; round < 400; round++) {
+        std::string pattern = random_regex(4);
+        CHECK(RegexToNFA::is_supported(pattern));
+
+        NFA nfa = RegexToNFA::from_regex(pattern);
+        BitParallelNFA bit_parallel(nfa);
+        LazyDFA lazy(nfa);
+        DFA dfa = convert_nfa_to_dfa(nfa);
+        DFA minimal = dfa;
+        minimize(minimal);
+        CHECK(std::as_const(minimal).get_states().size() <= std::as_const(dfa).get_states().size());
+        CompiledRegex compiled(pattern, PATTERN_DEFAULT);
+        CHECK(compiled.uses_own_engine());
+        std::regex reference(pattern);
+
+        for (int t = 0; t < 40; t++) {
+            std::string text = random_text("abcd", 4);
+            bool expected = std::regex_match(text, reference);
+            CHECK(nfa.simulate(text) == expected);
+            CHECK(bit_parallel.simulate(text) == expected);
+            CHECK(lazy.simulate(text) == expected);
+            CHECK(dfa.simulate(text) == expected);
+            CHECK(minimal.simulate(text) == expected);
+            CHECK(compiled.match(text) == expected);
+        }
+    }
+}
+
+static void test_case_insensitive() {
+    for (int round = 0; round < 200; round++) {
+        std::string pattern = random_regex(3);
+        CompiledRegex compiled(pattern, PATTERN_ICASE);
+        std::regex reference(pattern, std::regex::ECMAScript | std::regex::icase);
+        for (int t = 0; t < 30; t++) {
+            std::string text = random_text("abAB", 4);
+            CHECK(compiled.match(text) == std::regex_match(text, reference));
+        }
+    }
+}
+
+// Syntax RegexToNFA does not take falls back to std::regex
+static void test_fallback() {
+    CompiledRegex anchored("^a[bc]+$", PATTERN_DEFAULT);
+    CHECK(!anchored.uses_own_engine());
+    CHECK(anchored.match("abcb"));
+    CHECK(!anchored.match("a"));
+
+    // ECMAScript '.' excludes line breaks; the DFA's '.' does not
+    CompiledRegex dot("a.b", PATTERN_DEFAULT);
+    CHECK(dot.match("axb"));
+    CHECK(!dot.match("a\nb"));
+}
+
+int main() {
+    test_engines_agree();
+    test_case_insensitive();
+    test_fallback();
+    return test_result();
+}
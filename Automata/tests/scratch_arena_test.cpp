@@ -0,0 +1,78 @@
+#include "check.hpp"
+#include "scratch_arena.hpp"
+#include <cstdint>
+#include <memory_resource>
+#include <vector>
+
+// Run one "message" that allocates `bytes` of scratch data
+static void use(ScratchArena& arena, size_t bytes) {
+    ScratchScope scope(arena);
+    std::pmr::vector<char> data(bytes, 'x', scope.resource());
+}
+
+static void test_growth() {
+    ScratchArena arena(1024);
+    CHECK(arena.capacity() == 1024);
+    use(arena, 100);
+    CHECK(arena.capacity() == 1024);
+
+    // Overflow goes to the heap; the reset regrows so it fits next time
+    use(arena, 10000);
+    size_t grown = arena.capacity();
+    CHECK(grown >= 10000);
+    use(arena, 10000);
+    CHECK(arena.capacity() == grown);
+}
+
+static void test_alignment_and_nesting() {
+    ScratchArena arena(1024);
+    ScratchScope outer(arena);
+    void* a = outer.resource()->allocate(3, 1);
+    void* b = outer.resource()->allocate(64, 64);
+    CHECK(reinterpret_cast<std::uintptr_t>(b) % 64 == 0);
+    {
+        // An inner scope does not release the outer one's memory
+        ScratchScope inner(arena);
+        void* scoped = inner.resource()->allocate(16, 8);
+        CHECK(scoped != a && scoped != b);
+    }
+    void* c = outer.resource()->allocate(1, 1);
+    CHECK(c != a && c != b);
+    void* big = outer.resource()->allocate(4096, 256);
+    CHECK(reinterpret_cast<std::uintptr_t>(big) % 256 == 0);
+}
+
+static void test_shrink_back() {
+    ScratchArena arena(1024);
+    use(arena, 100000);
+    size_t grown = arena.capacity();
+    CHECK(grown >= 100000);
+
+    // Small messages: the buffer stays until SHRINK_AFTER_RESETS quiet
+    // resets in a row, then drops back, keeping room for them
+    for (size_t i = 1; i < ScratchArena::SHRINK_AFTER_RESETS; i++) use(arena, 3000);
+    CHECK(arena.capacity() == grown);
+    use(arena, 3000);
+    CHECK(arena.capacity() < grown / 4);
+    CHECK(arena.capacity() >= 3000);
+    size_t shrunk = arena.capacity();
+    use(arena, 3000);
+    CHECK(arena.capacity() == shrunk);
+
+    // A busy reset (a quarter or more of the buffer) starts the count over
+    use(arena, 100000);
+    grown = arena.capacity();
+    for (size_t i = 1; i < ScratchArena::SHRINK_AFTER_RESETS; i++) use(arena, 10);
+    use(arena, grown / 2);
+    for (size_t i = 1; i < ScratchArena::SHRINK_AFTER_RESETS; i++) use(arena, 10);
+    CHECK(arena.capacity() == grown);
+    use(arena, 10);
+    CHECK(arena.capacity() == 1024);  // Never below the initial size
+}
+
+int main() {
+    test_growth();
+    test_alignment_and_nesting();
+    test_shrink_back();
+    return test_result();
+}
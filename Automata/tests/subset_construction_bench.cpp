@@ -0,0 +1,167 @@
+#include "dfa_engine.hpp"
+#include "nfa_engine.hpp"
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <queue>
+#include <random>
+#include <set>
+#include <string>
+#include <unordered_map>
+#include <unordered_set>
+#include <utility>
+#include <vector>
+
+// Benchmark: convert_nfa_to_dfa against the subset construction it
+// replaced (string keys, closures recomputed per symbol), on blocklists of
+// random 4-9 letter words compiled as one alternation. Not run by ctest.
+//
+//   subset_construction_bench [max_patterns]
+
+// ==================== PREVIOUS CONSTRUCTION ====================
+
+static DFA string_keyed_nfa_to_dfa(const NFA& nfa) {
+    DFA dfa;
+    std::unordered_map<std::string, int> state_map;
+    std::queue<std::unordered_set<int>> q;
+    int next_id = 0;
+
+    std::set<char> alphabet;
+    const auto& nfa_nodes = nfa.get_nodes();
+    for (const auto& node : nfa_nodes) {
+        for (const auto& trans : node->transitions) {
+            if (trans.first != NFA::WILDCARD) alphabet.insert(trans.first);
+        }
+    }
+
+    auto closure_to_key = [](const std::unordered_set<int>& s) {
+        if (s.empty()) return std::string("DEAD");
+        std::vector<int> v(s.begin(), s.end());
+        std::sort(v.begin(), v.end());
+        std::string key;
+        for (int x : v) key += std::to_string(x) + ",";
+        return key;
+    };
+    auto is_final = [&](const std::unordered_set<int>& set) {
+        for (int f : nfa.get_final_states()) {
+            if (set.count(f)) return true;
+        }
+        return false;
+    };
+
+    std::unordered_set<int> start_set = nfa.epsilon_closure({nfa.get_start_state()});
+    state_map[closure_to_key(start_set)] = next_id++;
+    DFAState start_state;
+    start_state.id = 0;
+    start_state.is_final = is_final(start_set);
+    dfa.get_states().push_back(start_state);
+    dfa.set_start_state(0);
+    if (!start_set.empty()) q.push(start_set);
+
+    while (!q.empty()) {
+        auto current_set = q.front();
+        q.pop();
+        int current_id = state_map[closure_to_key(current_set)];
+
+        std::unordered_set<int> wildcard_dests;
+        for (int s : current_set) {
+            auto it = nfa_nodes[s]->transitions.find(NFA::WILDCARD);
+            if (it != nfa_nodes[s]->transitions.end()) wildcard_dests.insert(it->second.begin(), it->second.end());
+        }
+        std::unordered_set<int> wildcard_closures = nfa.epsilon_closure(wildcard_dests);
+
+        for (char symbol : alphabet) {
+            std::unordered_set<int> next_set_raw = wildcard_closures;
+            for (int s : current_set) {
+                auto it = nfa_nodes[s]->transitions.find(symbol);
+                if (it != nfa_nodes[s]->transitions.end()) next_set_raw.insert(it->second.begin(), it->second.end());
+            }
+            std::unordered_set<int> next_set = nfa.epsilon_closure(next_set_raw);
+            if (next_set.empty()) continue;
+
+            std::string next_key = closure_to_key(next_set);
+            auto found = state_map.find(next_key);
+            int to;
+            if (found == state_map.end()) {
+                to = next_id++;
+                state_map[next_key] = to;
+                DFAState ns;
+                ns.id = to;
+                ns.is_final = is_final(next_set);
+                dfa.get_states().push_back(ns);
+                q.push(next_set);
+            } else {
+                to = found->second;
+            }
+            dfa.get_states()[current_id].transitions[symbol] = to;
+        }
+    }
+
+    // Missing transitions go to an explicit dead state
+    int dead_id = next_id;
+    DFAState dead_state;
+    dead_state.id = dead_id;
+    dead_state.is_final = false;
+    for (char c : alphabet) dead_state.transitions[c] = dead_id;
+    dfa.get_states().push_back(dead_state);
+    for (auto& state : dfa.get_states()) {
+        for (char c : alphabet) state.transitions.try_emplace(c, dead_id);
+    }
+    return dfa;
+}
+
+// ==================== HARNESS ====================
+
+template <typename F>
+static double median_ms(F&& f) {
+    std::vector<double> runs;
+    for (int run = 0; run < 3; run++) {
+        auto t0 = std::chrono::steady_clock::now();
+        f();
+        runs.push_back(std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - t0).count());
+    }
+    std::sort(runs.begin(), runs.end());
+    return runs[1];
+}
+
+int main(int argc, char** argv) {
+    size_t max_patterns = argc > 1 ? std::max<size_t>(std::strtoul(argv[1], nullptr, 10), 4) : 1000;
+    std::mt19937 rng(42);
+    std::vector<std::string> words;
+    while (words.size() < max_patterns) {
+        std::string word(4 + rng() % 6, 'a');
+        for (char& c : word) c = static_cast<char>('a' + rng() % 26);
+        words.push_back(word);
+    }
+
+    std::printf("patterns  NFA states  old (ms)  new (ms)  speedup\n");
+    bool same = true;
+    for (size_t count : {max_patterns / 4, max_patterns / 2, max_patterns}) {
+        std::string regex = "(" + words[0];
+        for (size_t i = 1; i < count; i++) regex += "|" + words[i];
+        regex += ")";
+        NFA nfa = RegexToNFA::from_regex(regex);
+
+        DFA old_dfa, new_dfa;
+        double old_ms = median_ms([&] { old_dfa = string_keyed_nfa_to_dfa(nfa); });
+        double new_ms = median_ms([&] { new_dfa = convert_nfa_to_dfa(nfa); });
+
+        // Both must recognize the same language
+        minimize(old_dfa);
+        minimize(new_dfa);
+        same = same && std::as_const(old_dfa).get_states().size() == std::as_const(new_dfa).get_states().size();
+        for (size_t i = 0; i < count + 200; i++) {
+            std::string probe = i < count ? words[i] : words[i % count].substr(1);
+            same = same && old_dfa.simulate(probe) == new_dfa.simulate(probe);
+        }
+
+        std::printf("%8zu  %10zu  %8.1f  %8.1f  %6.1fx\n", count, nfa.get_nodes().size(), old_ms, new_ms,
+                    old_ms / new_ms);
+    }
+    if (!same) {
+        std::fprintf(stderr, "old and new constructions disagree\n");
+        return EXIT_FAILURE;
+    }
+    return EXIT_SUCCESS;
+}
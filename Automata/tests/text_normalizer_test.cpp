@@ -0,0 +1,75 @@
+#include "check.hpp"
+#include "cpu_features.hpp"
+#include "text_normalizer.hpp"
+#include <cstdint>
+#include <random>
+#include <string>
+#include <vector>
+
+// normalize_text (AVX2 when available) against a plain walk through
+// NORMALIZE_TABLE
+
+static std::string reference(std::string_view text, std::vector<std::uint32_t>& offsets) {
+    std::string out;
+    offsets.clear();
+    for (size_t i = 0; i < text.size(); i++) {
+        unsigned char mapped = NORMALIZE_TABLE[static_cast<unsigned char>(text[i])];
+        if (mapped == 0) continue;
+        out += static_cast<char>(mapped);
+        offsets.push_back(static_cast<std::uint32_t>(i));
+    }
+    return out;
+}
+
+static void check_against_reference(std::string_view text) {
+    std::vector<std::uint32_t> expected_offsets;
+    std::string expected = reference(text, expected_offsets);
+
+    std::string out(text.size(), '\0');
+    std::vector<std::uint32_t> offsets(text.size());
+    size_t written = normalize_text(text, out.data(), offsets.data());
+    CHECK(out.substr(0, written) == expected);
+    offsets.resize(written);
+    CHECK(offsets == expected_offsets);
+
+    // Without offsets
+    std::string plain(text.size(), '\0');
+    CHECK(plain.substr(0, normalize_text(text, plain.data())) == expected);
+}
+
+static void test_table() {
+    std::string out(32, '\0');
+    std::string_view text = "H3ll0, W0RLD!  $t@y 1337 \xc3\xa9";
+    out.resize(normalize_text(text, out.data()));
+    CHECK(out == "hello worldi  stay ieet ");
+}
+
+static void test_random() {
+    std::mt19937 rng(18);
+    // Byte mixes: anything, mostly kept (whole-block fast path), mostly stripped
+    const std::string kept = "abcXYZ 0123456789\t@$!";
+    const std::string stripped = ".,;:-_\"'\x01\x7f\x80\xff";
+    for (int round = 0; round < 3000; round++) {
+        std::string text(rng() % 300, '\0');
+        int mix = round % 3;
+        for (char& c : text) {
+            if (mix == 0) c = static_cast<char>(rng() % 256);
+            else if (mix == 1) c = rng() % 16 ? kept[rng() % kept.size()] : stripped[rng() % stripped.size()];
+            else c = rng() % 16 ? stripped[rng() % stripped.size()] : kept[rng() % kept.size()];
+        }
+        // Unaligned starts and lengths around the 32-byte block size
+        size_t skip = text.empty() ? 0 : rng() % std::min<size_t>(text.size(), 33);
+        check_against_reference(std::string_view(text).substr(skip));
+    }
+    for (size_t length = 0; length <= 100; length++) {
+        check_against_reference(std::string(length, 'A'));
+        check_against_reference(std::string(length, '.'));
+    }
+}
+
+int main() {
+    std::cout << "AVX2 kernel " << (cpu_has_avx2() ? "enabled" : "not available") << "\n";
+    test_table();
+    test_random();
+    return test_result();
+}
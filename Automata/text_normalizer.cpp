@@ -0,0 +1,137 @@
+#include "text_normalizer.hpp"
+#include "cpu_features.hpp"
+
+#if HAVE_X86_SIMD
+#include <immintrin.h>
+#endif
+
+namespace {
+    // ASCII rows of NORMALIZE_TABLE: row h holds the entries for bytes
+    // 0xh0..0xhF, ready to be indexed by the low nibble with a shuffle.
+    // Bytes 0x80 and up have no row and come out as 0, as in the table.
+    struct NibbleRows {
+        alignas(16) unsigned char row[8][16];
+    };
+
+    constexpr NibbleRows make_nibble_rows() {
+        NibbleRows rows{};
+        for (int h = 0; h < 8; h++) {
+            for (int l = 0; l < 16; l++) rows.row[h][l] = NORMALIZE_TABLE[h * 16 + l];
+        }
+        return rows;
+    }
+
+    // For each 8-bit keep mask: the positions of the kept bytes, packed to
+    // the front, and how many there are
+    struct CompactTable {
+        alignas(8) unsigned char index[256][8];
+        unsigned char count[256];
+    };
+
+    constexpr CompactTable make_compact_table() {
+        CompactTable table{};
+        for (int mask = 0; mask < 256; mask++) {
+            int n = 0;
+            for (int bit = 0; bit < 8; bit++) {
+                if (mask & (1 << bit)) table.index[mask][n++] = static_cast<unsigned char>(bit);
+            }
+            for (int k = n; k < 8; k++) table.index[mask][k] = 0x80;  // shuffles to zero
+            table.count[mask] = static_cast<unsigned char>(n);
+        }
+        return table;
+    }
+
+    constexpr NibbleRows NIBBLE_ROWS = make_nibble_rows();
+    constexpr CompactTable COMPACT = make_compact_table();
+
+    constexpr size_t AVX2_BLOCK = 32;
+}
+
+// ==================== AVX2 KERNEL ====================
+
+#if HAVE_X86_SIMD
+// Normalizes whole 32-byte blocks; returns bytes written, sets consumed
+TARGET_AVX2
+static size_t normalize_avx2(std::string_view text, char* out, std::uint32_t* offsets, size_t& consumed) {
+    const __m256i nibble = _mm256_set1_epi8(0x0F);
+    const __m256i zero = _mm256_setzero_si256();
+    __m256i rows[8];
+    for (int h = 0; h < 8; h++) {
+        rows[h] = _mm256_broadcastsi128_si256(
+            _mm_load_si128(reinterpret_cast<const __m128i*>(NIBBLE_ROWS.row[h])));
+    }
+
+    size_t i = 0;
+    size_t w = 0;
+    for (; i + AVX2_BLOCK <= text.size(); i += AVX2_BLOCK) {
+        __m256i v = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(text.data() + i));
+        __m256i lo = _mm256_and_si256(v, nibble);
+        __m256i hi = _mm256_and_si256(_mm256_srli_epi16(v, 4), nibble);
+
+        // One shuffle per ASCII row, each kept only where the high nibble
+        // selects that row
+        __m256i mapped = zero;
+        for (int h = 0; h < 8; h++) {
+            __m256i in_row = _mm256_cmpeq_epi8(hi, _mm256_set1_epi8(static_cast<char>(h)));
+            mapped = _mm256_or_si256(mapped, _mm256_and_si256(in_row, _mm256_shuffle_epi8(rows[h], lo)));
+        }
+
+        std::uint32_t keep = ~static_cast<std::uint32_t>(_mm256_movemask_epi8(_mm256_cmpeq_epi8(mapped, zero)));
+        if (keep == 0xFFFFFFFFu) {
+            // Nothing stripped: store the block as is
+            _mm256_storeu_si256(reinterpret_cast<__m256i*>(out + w), mapped);
+            if (offsets) {
+                __m256i base = _mm256_add_epi32(_mm256_set1_epi32(static_cast<int>(i)),
+                                                _mm256_setr_epi32(0, 1, 2, 3, 4, 5, 6, 7));
+                for (int q = 0; q < 4; q++) {
+                    _mm256_storeu_si256(reinterpret_cast<__m256i*>(offsets + w + 8 * q),
+                                        _mm256_add_epi32(base, _mm256_set1_epi32(8 * q)));
+                }
+            }
+            w += AVX2_BLOCK;
+            continue;
+        }
+
+        // Compact 8 bytes at a time. Each store writes a full 8 bytes but
+        // advances only past the kept ones; w never passes i, so the store
+        // stays inside the caller's text.size() bytes.
+        alignas(32) unsigned char block[AVX2_BLOCK];
+        _mm256_store_si256(reinterpret_cast<__m256i*>(block), mapped);
+        for (int g = 0; g < 4; g++) {
+            unsigned mask = (keep >> (8 * g)) & 0xFF;
+            __m128i group = _mm_loadl_epi64(reinterpret_cast<const __m128i*>(block + 8 * g));
+            __m128i index = _mm_loadl_epi64(reinterpret_cast<const __m128i*>(COMPACT.index[mask]));
+            _mm_storel_epi64(reinterpret_cast<__m128i*>(out + w), _mm_shuffle_epi8(group, index));
+            if (offsets) {
+                // Same positions widened to 32 bits (unused 0x80 lanes land
+                // past the kept ones and are overwritten or ignored)
+                __m256i positions = _mm256_add_epi32(_mm256_cvtepu8_epi32(index),
+                                                     _mm256_set1_epi32(static_cast<int>(i + 8 * g)));
+                _mm256_storeu_si256(reinterpret_cast<__m256i*>(offsets + w), positions);
+            }
+            w += COMPACT.count[mask];
+        }
+    }
+    consumed = i;
+    return w;
+}
+#endif
+
+// ==================== DISPATCH ====================
+
+size_t normalize_text(std::string_view text, char* out, std::uint32_t* offsets) {
+    size_t i = 0;
+    size_t w = 0;
+#if HAVE_X86_SIMD
+    if (text.size() >= AVX2_BLOCK && cpu_has_avx2()) {
+        w = normalize_avx2(text, out, offsets, i);
+    }
+#endif
+    for (; i < text.size(); i++) {
+        unsigned char c = NORMALIZE_TABLE[static_cast<unsigned char>(text[i])];
+        if (!c) continue;
+        if (offsets) offsets[w] = static_cast<std::uint32_t>(i);
+        out[w++] = static_cast<char>(c);
+    }
+    return w;
+}
@@ -0,0 +1,55 @@
+#ifndef TEXT_NORMALIZER_HPP
+#define TEXT_NORMALIZER_HPP
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <string_view>
+
+/**
+ * @file text_normalizer.hpp
+ * @brief Byte-wise text normalization for approximate matching
+ *
+ * Every byte maps through one 256-entry table: ASCII letters become
+ * lowercase, leet digits and symbols fold to the letters they stand for,
+ * other digits and ASCII whitespace are kept, and everything else
+ * (punctuation, control bytes, non-ASCII) maps to 0 and is stripped.
+ */
+
+namespace detail {
+    constexpr std::array<unsigned char, 256> make_normalize_table() {
+        std::array<unsigned char, 256> table{};
+        for (int c = '0'; c <= '9'; c++) table[c] = static_cast<unsigned char>(c);
+        for (int c = 'a'; c <= 'z'; c++) table[c] = static_cast<unsigned char>(c);
+        for (int c = 'A'; c <= 'Z'; c++) table[c] = static_cast<unsigned char>(c - 'A' + 'a');
+        for (char c : {' ', '\t', '\n', '\v', '\f', '\r'}) table[static_cast<unsigned char>(c)] = static_cast<unsigned char>(c);
+
+        // Leet folding
+        table['1'] = 'i'; table['!'] = 'i';
+        table['0'] = 'o';
+        table['3'] = 'e';
+        table['4'] = 'a'; table['@'] = 'a';
+        table['5'] = 's'; table['$'] = 's';
+        table['7'] = 't';
+        return table;
+    }
+}
+
+/// Byte -> normalized byte, or 0 to strip it
+inline constexpr std::array<unsigned char, 256> NORMALIZE_TABLE = detail::make_normalize_table();
+
+/**
+ * @brief Normalize text through NORMALIZE_TABLE, dropping stripped bytes
+ *
+ * Runs an AVX2 nibble-table kernel when the CPU has it, the table lookup
+ * otherwise; the output is the same either way.
+ *
+ * @param text Input bytes (under 4 GiB when offsets are requested)
+ * @param out Receives the normalized bytes; room for text.size() bytes
+ * @param offsets If not null, receives for each output byte the offset of
+ *        the input byte it came from; room for text.size() entries
+ * @return Number of bytes written to out
+ */
+size_t normalize_text(std::string_view text, char* out, std::uint32_t* offsets = nullptr);
+
+#endif // TEXT_NORMALIZER_HPP
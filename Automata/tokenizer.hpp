@@ -0,0 +1,69 @@
+#ifndef TOKENIZER_HPP
+#define TOKENIZER_HPP
+
+#include <string_view>
+#include <cstddef>
+
+/**
+ * @struct Token
+ * @brief One whitespace-separated token, viewing its source text
+ */
+struct Token {
+    std::string_view text;  ///< The token's bytes (a view into the source)
+    size_t offset;          ///< Byte offset of the token in the source
+
+    size_t end() const { return offset + text.size(); }
+};
+
+/**
+ * @brief ASCII whitespace, as isspace() in the "C" locale, but independent
+ *        of the current locale
+ */
+constexpr bool is_token_space(char c) {
+    return c == ' ' || c == '\t' || c == '\n' || c == '\v' || c == '\f' || c == '\r';
+}
+
+/**
+ * @class Tokenizer
+ * @brief Splits text into whitespace-separated tokens without copying
+ *
+ * The shared tokenizer for all matchers: tokens are views into the
+ * source, so nothing is allocated, and each carries its byte offset, so a
+ * match found in a token can be reported as a span of the original text.
+ * The source must outlive the tokenizer and its tokens.
+ */
+class Tokenizer {
+public:
+    explicit Tokenizer(std::string_view source) : source(source) {}
+
+    /**
+     * @brief Advance to the next token
+     * @return false once the source is exhausted
+     */
+    bool next(Token& token) {
+        while (pos < source.size() && is_token_space(source[pos])) pos++;
+        if (pos == source.size()) return false;
+
+        size_t start = pos;
+        while (pos < source.size() && !is_token_space(source[pos])) pos++;
+        token.text = source.substr(start, pos - start);
+        token.offset = start;
+        return true;
+    }
+
+    /**
+     * @brief Call f(token) for every token of source
+     */
+    template <typename F>
+    static void for_each(std::string_view source, F&& f) {
+        Tokenizer tokenizer(source);
+        Token token;
+        while (tokenizer.next(token)) f(token);
+    }
+
+private:
+    std::string_view source;
+    size_t pos = 0;
+};
+
+#endif // TOKENIZER_HPP
@@ -1,73 +1,185 @@
 // toxicity_analyzer.cpp
 #include "toxicity_analyzer.hpp"
+#include "scratch_arena.hpp"
 #include <sstream>
 #include <algorithm>
+#include <cctype>
+#include <cstdint>
+#include <limits>
+#include <stdexcept>
 
-ToxicityAnalyzer::ToxicityAnalyzer() 
-    : toxic_nfa(std::move(RegexToNFA::from_regex("idiot|stupid|ugly|dumb"))),
-      bracket_pda(BracketPDA::create_balanced_bracket_pda()),
-      formatting_pda() {  // Changed to default constructor
+ToxicityAnalyzer::ToxicityAnalyzer(bool verbose_matching, std::shared_ptr<const Blocklist> extra_words) 
+    : approx_matcher(verbose_matching),
+      blocklist(std::move(extra_words)),
+      toxic_words(ToxicLexicon::word_list()),
+      builtin_words(toxic_words.size()),
+      approx_pattern(".*") {
+    if (blocklist) toxic_words.insert(toxic_words.end(), blocklist->words().begin(), blocklist->words().end());
+    batch_pattern_names = toxic_words;
+    batch_pattern_names.push_back(approx_pattern);
 }
 
-ToxicityAnalyzer::AnalysisResult ToxicityAnalyzer::analyze_message(const std::string& message) {
+ToxicityAnalyzer::AnalysisResult ToxicityAnalyzer::analyze_message(std::string_view message) {
     AnalysisResult result;
     result.message = message;
     result.toxicity_score = 0;
 
     result.exact_matches = find_exact_matches(message);
-    result.toxicity_score += result.exact_matches.size() * 30;
+    result.toxicity_score += result.exact_matches.size() * EXACT_MATCH_POINTS;
 
-    result.approx_matches = approx_matcher.find_matches(message, ".*", 1);
-    result.toxicity_score += result.approx_matches.size() * 20;
+    result.approx_matches = approx_matcher.find_matches(message, approx_pattern, APPROX_MAX_EDITS);
+    result.toxicity_score += result.approx_matches.size() * APPROX_MATCH_POINTS;
 
     result.valid_structure = validate_structures(message);
     result.structure_type = result.valid_structure ? "Valid" : "Invalid";
     
     if (!result.valid_structure) {
-        result.toxicity_score += 10;
+        result.toxicity_score += INVALID_STRUCTURE_POINTS;
     }
 
     result.toxicity_score = std::min(100, result.toxicity_score);
     return result;
 }
 
-std::vector<std::string> ToxicityAnalyzer::find_exact_matches(const std::string& message) {
-    std::vector<std::string> matches;
-    std::istringstream ss(message);
-    std::string word;
+// ==================== COMPONENTS ====================
 
-    std::vector<std::string>toxic_words = {
-    "idiot","stupid","dumb","trash"};
+template <typename F>
+void ToxicityAnalyzer::for_each_exact_match(std::string_view message, F&& on_match) {
+    // One automaton pass per token. Tokens lose their non-alphanumeric
+    // characters before matching, so the automaton restarts at each token
+    // and simply skips other non-alnum bytes. Each word is reported at
+    // most once per token, in toxic_words order, with the token's span.
+    // A blocklist word must spell the whole token.
+    token_seen.assign(toxic_words.size(), 0);
+    Tokenizer::for_each(message, [&](const Token& token) {
+        token_hits.clear();
+        int state = ToxicLexicon::start_state();
+        for (char ch : token.text) {
+            unsigned char c = static_cast<unsigned char>(ch);
+            if (!std::isalnum(c)) continue;
 
-
-    while (ss >> word) {
-        word.erase(std::remove_if(word.begin(), word.end(), 
-            [](char c) { return !std::isalnum(c); }), word.end());
-        
-        for (const auto& toxic_word : toxic_words) {
-            if (word.find(toxic_word) != std::string::npos) {
-                matches.push_back(toxic_word);
+            state = ToxicLexicon::next_state(state, c);
+            ToxicLexicon::for_each_output(state, [&](int id) {
+                if (!token_seen[id]) {
+                    token_seen[id] = 1;
+                    token_hits.push_back(id);
+                }
+            });
+        }
+        if (blocklist) {
+            int word = blocklist->match(token.text);
+            int id = static_cast<int>(builtin_words) + word;
+            if (word >= 0 && !token_seen[id]) {
+                token_seen[id] = 1;
+                token_hits.push_back(id);
             }
         }
-    }
 
+        std::sort(token_hits.begin(), token_hits.end());
+        for (int id : token_hits) {
+            on_match(token.offset, token.text.size(), id);
+            token_seen[id] = 0;
+        }
+    });
+}
+
+std::vector<ToxicityAnalyzer::ExactMatch> ToxicityAnalyzer::find_exact_matches(std::string_view message) {
+    std::vector<ExactMatch> matches;
+    for_each_exact_match(message, [&](size_t offset, size_t length, int id) {
+        matches.push_back({toxic_words[id], offset, length});
+    });
     return matches;
 }
 
-bool ToxicityAnalyzer::validate_structures(const std::string& message) {
-    std::string structure_chars;
-    for (char c : message) {
-        if (c == '(' || c == ')' || c == '{' || c == '}' || 
-            c == '[' || c == ']' || c == '<' || c == '>' ||
-            c == '*') {
-            structure_chars += c;
-        }
+bool ToxicityAnalyzer::validate_structures(std::string_view message) {
+    // Same answer as PDA::simulate() on the message, without copying out
+    // its structural characters first. Multi-megabyte pastes are split
+    // across the pool. Neither path has a depth limit: nesting deeper
+    // than validate_brackets() tracks is rechecked with the unbounded
+    // chunk summaries (on this thread, for a short message).
+    if (message.size() >= PARALLEL_STRUCTURE_BYTES) return ParallelPDA::simulate(message).valid;
+    BracketValidation result = validate_brackets(message);
+    if (result.depth_exceeded) return ParallelPDA::simulate(message).valid;
+    return result.valid;
+}
+
+// ==================== BATCH ANALYSIS ====================
+
+void ToxicityAnalyzer::BatchResults::clear() {
+    scores.clear();
+    valid_structure.clear();
+    exact_counts.clear();
+    approx_counts.clear();
+    match_begin.clear();
+    match_offsets.clear();
+    match_lengths.clear();
+    match_pattern_ids.clear();
+    match_distances.clear();
+}
+
+void ToxicityAnalyzer::analyze_batch(std::span<const std::string_view> messages, BatchResults& out) {
+    static_assert(APPROX_MAX_EDITS <= std::numeric_limits<std::uint8_t>::max(), "distances are stored in a byte");
+    constexpr size_t MAX_32 = std::numeric_limits<std::uint32_t>::max();
+    if (batch_pattern_names.size() > size_t{std::numeric_limits<std::uint16_t>::max()} + 1) {
+        throw std::length_error("analyze_batch: too many patterns for 16-bit pattern ids");
     }
 
-    if (!structure_chars.empty()) {
-        return bracket_pda.simulate(structure_chars) || 
-               formatting_pda.simulate(structure_chars);
+    const size_t n = messages.size();
+    out.clear();
+    out.scores.resize(n);
+    out.valid_structure.resize(n);
+    out.exact_counts.resize(n);
+    out.approx_counts.resize(n);
+    out.match_begin.resize(n + 1);
+
+    auto add_match = [&out](size_t offset, size_t length, size_t pattern_id, int distance) {
+        out.match_offsets.push_back(static_cast<std::uint32_t>(offset));
+        out.match_lengths.push_back(static_cast<std::uint32_t>(length));
+        out.match_pattern_ids.push_back(static_cast<std::uint16_t>(pattern_id));
+        out.match_distances.push_back(static_cast<std::uint8_t>(distance));
+    };
+    const size_t approx_id = toxic_words.size();
+
+    // Matching pass: per message, append to the match arrays and count.
+    // Scratch the matchers take from the arena is released per message.
+    for (size_t i = 0; i < n; i++) {
+        ScratchScope scope;
+        std::string_view message = messages[i];
+        if (message.size() > MAX_32 || out.match_offsets.size() > MAX_32) {
+            throw std::length_error("analyze_batch: batch too large for 32-bit match offsets");
+        }
+        out.match_begin[i] = static_cast<std::uint32_t>(out.match_offsets.size());
+
+        std::uint32_t exact = 0;
+        for_each_exact_match(message, [&](size_t offset, size_t length, int id) {
+            add_match(offset, length, static_cast<size_t>(id), 0);
+            exact++;
+        });
+
+        // Same words find_matches() sees
+        std::uint32_t approx = 0;
+        ApproximateMatcher::for_each_word(message, [&](std::string_view word, const Token& token) {
+            int dist = approx_matcher.match_word(word, approx_pattern, APPROX_MAX_EDITS);
+            if (dist >= 0) {
+                add_match(token.offset, token.text.size(), approx_id, dist);
+                approx++;
+            }
+        });
+
+        out.exact_counts[i] = exact;
+        out.approx_counts[i] = approx;
+        out.valid_structure[i] = validate_structures(message) ? 1 : 0;
     }
+    if (out.match_offsets.size() > MAX_32) {
+        throw std::length_error("analyze_batch: batch too large for 32-bit match offsets");
+    }
+    out.match_begin[n] = static_cast<std::uint32_t>(out.match_offsets.size());
 
-    return true;
+    // Scoring pass: branch-free over the per-message arrays
+    for (size_t i = 0; i < n; i++) {
+        int score = static_cast<int>(out.exact_counts[i]) * EXACT_MATCH_POINTS +
+                    static_cast<int>(out.approx_counts[i]) * APPROX_MATCH_POINTS +
+                    (1 - out.valid_structure[i]) * INVALID_STRUCTURE_POINTS;
+        out.scores[i] = std::min(100, score);
+    }
 }
\ No newline at end of file
@@ -2,37 +2,129 @@
 #ifndef TOXICITY_ANALYZER_HPP
 #define TOXICITY_ANALYZER_HPP
 
-#include "nfa_engine.hpp"
 #include "approximate_matcher.hpp"
-#include "pda_engine.hpp"
+#include "blocklist.hpp"
+#include "bracket_validator.hpp"
+#include "parallel_pda.hpp"
+#include "static_lexicon.hpp"
+#include "tokenizer.hpp"
+#include <memory>
 #include <vector>
 #include <string>
+#include <string_view>
+#include <span>
+#include <cstdint>
 #include <sstream>
 #include <algorithm>
 
 class ToxicityAnalyzer {
 private:
-    NFA toxic_nfa;
+    // The built-in blocklist, compiled into a static automaton
+    using ToxicLexicon = StaticLexicon<"idiot", "stupid", "dumb", "trash">;
+
     ApproximateMatcher approx_matcher;
-    PDA bracket_pda;
-    PDA formatting_pda;
+    std::shared_ptr<const Blocklist> blocklist;
+    std::vector<std::string> toxic_words;  // ToxicLexicon's words, then the blocklist's, by id
+    size_t builtin_words;
+    std::string approx_pattern;
+    std::vector<std::string> batch_pattern_names;  // toxic_words, then approx_pattern
+
+    static constexpr int EXACT_MATCH_POINTS = 30;
+    static constexpr int APPROX_MATCH_POINTS = 20;
+    static constexpr int INVALID_STRUCTURE_POINTS = 10;
+    static constexpr int APPROX_MAX_EDITS = 1;
+
+    // Messages at least this long get their structure checked in parallel
+    static constexpr size_t PARALLEL_STRUCTURE_BYTES = 4 * ParallelPDA::DEFAULT_CHUNK_BYTES;
+
+    // Scratch reused across messages
+    std::vector<int> token_hits;
+    std::vector<char> token_seen;
+
+public:
+    /**
+     * @struct ExactMatch
+     * @brief A toxic word found in a message, with the span of its token
+     */
+    struct ExactMatch {
+        std::string word;  ///< The toxic word
+        size_t offset;     ///< Byte offset of the token containing it
+        size_t length;     ///< Byte length of that token
+    };
 
-    std::vector<std::string> find_exact_matches(const std::string& message);
-    bool validate_structures(const std::string& message);
+private:
+    template <typename F>
+    void for_each_exact_match(std::string_view message, F&& on_match);
+    std::vector<ExactMatch> find_exact_matches(std::string_view message);
+    bool validate_structures(std::string_view message);
 
 public:
-    ToxicityAnalyzer();
+    /**
+     * @param verbose_matching Print the approximate matcher's per-word trace
+     * @param blocklist Extra words, matched as whole tokens after the
+     *        built-in ones and scored the same
+     */
+    explicit ToxicityAnalyzer(bool verbose_matching = true, std::shared_ptr<const Blocklist> blocklist = nullptr);
 
     struct AnalysisResult {
         int toxicity_score;
-        std::vector<std::string> exact_matches;
+        std::vector<ExactMatch> exact_matches;
         std::vector<ApproximateMatcher::MatchResult> approx_matches;
         bool valid_structure;
         std::string structure_type;
         std::string message;
     };
 
-    AnalysisResult analyze_message(const std::string& message);
+    AnalysisResult analyze_message(std::string_view message);
+
+    /**
+     * @struct BatchResults
+     * @brief Structure-of-arrays results for a batch of messages
+     *
+     * Caller-owned and reused: analyze_batch() clears it but keeps the
+     * capacity, so once warmed up a batch adds no result allocations. The
+     * matches of message i are entries [match_begin[i], match_begin[i + 1])
+     * of the match arrays, exact matches first, then approximate ones, in
+     * the order analyze_message() reports them.
+     *
+     * The arrays are narrow, so a batch has limits: messages under 4 GiB
+     * and fewer than 2^32 matches in all (32-bit offsets and match_begin),
+     * and at most 65536 pattern names (16-bit ids). analyze_batch() checks
+     * them. Distances fit a byte because APPROX_MAX_EDITS is small.
+     */
+    struct BatchResults {
+        // One entry per message
+        std::vector<int> scores;
+        std::vector<std::uint8_t> valid_structure;
+        std::vector<std::uint32_t> exact_counts;
+        std::vector<std::uint32_t> approx_counts;
+        std::vector<std::uint32_t> match_begin;        ///< size() + 1 entries
+
+        // One entry per match
+        std::vector<std::uint32_t> match_offsets;      ///< Byte offset of the matched word in its message
+        std::vector<std::uint32_t> match_lengths;      ///< Byte length of that word
+        std::vector<std::uint16_t> match_pattern_ids;  ///< Index into pattern_names()
+        std::vector<std::uint8_t> match_distances;     ///< Edit distance, 0 for exact matches
+
+        size_t size() const { return scores.size(); }
+        void clear();
+    };
+
+    /**
+     * @brief Analyze many messages into a reusable SoA arena
+     *
+     * Scores equal analyze_message()'s. Views only need to stay valid for
+     * the duration of the call.
+     *
+     * @throws std::length_error if the batch exceeds BatchResults' limits
+     */
+    void analyze_batch(std::span<const std::string_view> messages, BatchResults& out);
+
+    /**
+     * @brief Names for BatchResults::match_pattern_ids: the toxic words
+     *        (built-in, then blocklist), then the approximate pattern
+     */
+    const std::vector<std::string>& pattern_names() const { return batch_pattern_names; }
 };
 
 #endif
\ No newline at end of file
@@ -2,7 +2,18 @@
 #include "nfa_engine.hpp"
 #include "approximate_matcher.hpp"
 #include "pda_engine.hpp"
+#include "pda_runner.hpp"
+#include "pda_stream.hpp"
+#include "parallel_pda.hpp"
+#include "deterministic_pda.hpp"
 #include "dfa_engine.hpp"
+#include "lazy_dfa.hpp"
+#include "pattern_cache.hpp"
+#include "xml_stream_reader.hpp"
+#include "mapped_file.hpp"
+#include "work_stealing_pool.hpp"
+#include "scratch_arena.hpp"
+#include "alloc_counter.hpp"
 #include <iomanip>
 #include <sstream>
 #include <iostream>
@@ -17,6 +28,9 @@
 #include <cctype>     // for ispunct, isalpha, tolower
 #include <regex>      // for regex_search
 #include <type_traits>  // for std::is_same_v
+#include <atomic>
+#include <thread>
+#include <memory_resource>
 
 
 namespace fs = std::filesystem;
@@ -108,22 +122,30 @@ void ChatModerationUI::analyze_toxic_phrases() {
         toxic_nfa.print_transitions();
 
         cout << "\n" << CYAN << "OPTIMIZATION OPTIONS:\n" << RESET;
-        cout << "Do you want to convert NFA to DFA for faster matching? (y/n): ";
+        cout << "Select matching engine:\n";
+        cout << "1. NFA (bit-parallel simulation)\n";
+        cout << "2. Lazy DFA (states built on demand)\n";
+        cout << "3. Full DFA (subset construction + minimization)\n";
+        cout << "Choice [1]: ";
         string input; 
         getline(cin, input);
-        char dfa_choice = !input.empty() ? tolower(input[0]) : 'n';
+        char engine_choice = !input.empty() ? input[0] : '1';
 
         DFA toxic_dfa;
         bool use_dfa = false;
+        bool use_lazy = (engine_choice == '2');
         
-        if (dfa_choice == 'y') {
+        if (engine_choice == '3') {
             cout << GREEN << " Converting NFA to DFA...\n" << RESET;
             toxic_dfa = convert_nfa_to_dfa(toxic_nfa);
+            size_t states_before = toxic_dfa.get_states().size();
+            minimize(toxic_dfa);
             use_dfa = true;
             cout << GREEN << " DFA conversion completed.\n" << RESET;
             
             cout << "\n" << CYAN << "DFA Statistics:\n" << RESET;
-            cout << "Number of states: " << toxic_dfa.get_states().size() << "\n";
+            cout << "States before minimization: " << states_before << "\n";
+            cout << "States after minimization: " << toxic_dfa.get_states().size() << "\n";
             int dead_states = 0;
             for (const auto& state : toxic_dfa.get_states()) {
                 bool is_dead = true;
@@ -150,24 +172,20 @@ void ChatModerationUI::analyze_toxic_phrases() {
 
         // Find all matches in the message
         vector<pair<int,int>> match_positions;
-        for (size_t i = 0; i < lower_msg.size(); ++i) {
-            for (size_t j = i+1; j <= lower_msg.size(); ++j) {
-                string substr = lower_msg.substr(i, j-i);
-                bool matched = use_dfa ? toxic_dfa.simulate(substr) : toxic_nfa.simulate(substr);
-                if (matched) {
-                    // Avoid overlapping matches
-                    bool overlap = false;
-                    for (const auto& [s, e] : match_positions) {
-                        if ((i >= s && i < e) || (j > s && j <= e)) {
-                            overlap = true;
-                            break;
-                        }
-                    }
-                    if (!overlap) {
-                        match_positions.push_back({static_cast<int>(i), static_cast<int>(j)});
-                    }
-                }
-            }
+        if (use_dfa) {
+            // Leftmost-longest spans in time linear in the message
+            match_positions = toxic_dfa.find_all(lower_msg);
+        } else if (use_lazy) {
+            // Determinize only the states the message actually visits
+            LazyDFA lazy(toxic_nfa);
+            match_positions = lazy.find_all(lower_msg);
+            cout << "\n" << CYAN << "Lazy DFA Statistics:\n" << RESET;
+            cout << "Cached states: " << lazy.cached_states() << "\n";
+            cout << "Cache clears: " << lazy.cache_clears() << "\n";
+        } else {
+            // Bit-parallel NFA simulation (no subset construction needed)
+            BitParallelNFA compiled_nfa(toxic_nfa);
+            match_positions = compiled_nfa.find_all(lower_msg);
         }
 
         // Highlight the message
@@ -316,6 +334,7 @@ void ChatModerationUI::analyze_disguised_toxicity() {
     cout << "\n" << CYAN << "ANALYSIS IN PROGRESS...\n" << RESET;
     
     auto matches = matcher.find_matches(message, pattern, max_edits);
+    print_pattern_cache_stats();
 
     if (matches.empty()) {
         cout << GREEN << "\n No approximate matches found.\n" << RESET;
@@ -339,17 +358,15 @@ void ChatModerationUI::analyze_disguised_toxicity() {
     
     for (const auto& [matched_pattern, pattern_matches] : grouped_matches) {
         for (const auto& match : pattern_matches) {
-            // Find position in original message
-            size_t pos = highlighted_msg.find(match.original);
-            if (pos != string::npos) {
-                match_positions.push_back({static_cast<int>(pos), 
-                                          static_cast<int>(pos + match.original.length())});
-            }
+            // Matches carry their span in the original message
+            match_positions.push_back({static_cast<int>(match.offset), 
+                                      static_cast<int>(match.offset + match.length)});
         }
     }
     
-    // Sort and highlight
+    // Sort and highlight (a word matching several patterns is marked once)
     sort(match_positions.begin(), match_positions.end());
+    match_positions.erase(unique(match_positions.begin(), match_positions.end()), match_positions.end());
     int offset = 0;
     for (const auto& [start, end] : match_positions) {
         highlighted_msg.insert(start + offset, YELLOW);
@@ -587,10 +604,21 @@ void ChatModerationUI::validate_structures() {
         }
     }
     
-    // Check for unmatched brackets
-    bool has_unmatched = !bracket_stack.empty() || 
-                        (user_input.find_first_of(")]}>") != string::npos && 
-                         user_input.find_first_of("([{<") != string::npos);
+    // Check for unmatched brackets: run the balanced-bracket PDA's table,
+    // which (unlike simulate()) also rejects stray and mismatched closers.
+    // It is deterministic, so it runs compiled; the nondeterministic
+    // runner gives the same answer if it ever stops compiling.
+    PDA bracket_pda = BracketPDA::create_balanced_bracket_pda();
+    DeterministicPDA bracket_dpda(bracket_pda);
+    bool has_unmatched = bracket_dpda.is_compiled() ? !bracket_dpda.accepts(user_input)
+                                                    : !PDARunner(bracket_pda).accepts(user_input);
+    
+    // Markdown formatting (bold, italic, strikethrough, brackets). Pasted
+    // input can be long, so this is the chunk-parallel check; it gives the
+    // same result as PDA::simulate_markdown().
+    vector<pair<int, int>> formatting_errors;
+    string formatting_message;
+    bool valid_formatting = ParallelPDA::simulate_markdown(user_input, formatting_errors, formatting_message);
     
     // DISPLAY RESULTS
     cout << "\n" << CYAN << "=== STRUCTURE VALIDATION RESULTS ===\n" << RESET;
@@ -616,6 +644,16 @@ void ChatModerationUI::validate_structures() {
         }
     }
     
+    cout << "Formatting: ";
+    if (valid_formatting) {
+        cout << GREEN << "VALID \n" << RESET;
+    } else {
+        cout << RED << "INVALID \n" << RESET;
+        cout << YELLOW << "  Reason: " << formatting_message;
+        if (!formatting_errors.empty()) cout << " (at position " << formatting_errors.front().first << ")";
+        cout << "\n" << RESET;
+    }
+    
     // Display bracket analysis
     if (!bracket_contents.empty()) {
         cout << "\n" << MAGENTA << "BRACKET ANALYSIS:\n" << RESET;
@@ -1045,6 +1083,18 @@ string ChatModerationUI::get_current_timestamp() {
     return string(buffer);
 }
 
+// Helper function to report the shared compiled-pattern cache
+void ChatModerationUI::print_pattern_cache_stats() {
+    PatternCache::Stats stats = PatternCache::global().stats();
+    size_t lookups = stats.hits + stats.misses;
+    cout << "Pattern cache: " << stats.size << "/" << stats.capacity << " entries, "
+         << stats.hits << " hits, " << stats.misses << " misses";
+    if (lookups > 0) {
+        cout << " (" << fixed << setprecision(1) << (100.0 * stats.hits / lookups) << "% hit rate)";
+    }
+    cout << ", " << stats.evictions << " evictions\n";
+}
+
 // Helper function to extract patterns from regex
 vector<string> ChatModerationUI::extract_patterns_from_regex(const string& regex) {
     vector<string> patterns;
@@ -1162,131 +1212,263 @@ void ChatModerationUI::analyze_chat_log() {
     
     cout << "\n" << BLUE << "ANALYZING XML DOCUMENT...\n" << RESET;
     
-    // Parse XML and analyze
-    vector<XMLMessageResult> results = parse_and_analyze_xml(filename, toxic_patterns, max_edits);
+    // Parse XML and analyze; toxic messages are shown as they are found
+    XMLAnalysisSummary summary = parse_and_analyze_xml(filename, toxic_patterns, max_edits);
     
-    if (results.empty()) {
+    if (summary.total_messages == 0) {
         cout << YELLOW << "No messages found in XML file or file format is invalid.\n" << RESET;
         return;
     }
     
-    // Display comprehensive results
-    display_xml_analysis(results, toxic_patterns, max_edits);
+    // Display summary and recommendations
+    display_xml_analysis(summary, toxic_patterns, max_edits);
+}
+
+void XMLAnalysisSummary::add(const XMLMessageResult& result) {
+    total_messages++;
+    if (!result.valid_formatting) broken_formatting++;
+    if (!result.has_toxic_content) {
+        clean_messages++;
+        return;
+    }
+    toxic_messages++;
+    total_exact += result.exact_matches.size();
+    total_approx += result.approx_matches.size();
+    total_brackets += result.bracket_contents.size();
+    for (const auto& bc : result.bracket_contents) {
+        if (bc.is_toxic) total_toxic_brackets++;
+    }
 }
 
 // Function to parse and analyze XML
-vector<XMLMessageResult> ChatModerationUI::parse_and_analyze_xml(
+XMLAnalysisSummary ChatModerationUI::parse_and_analyze_xml(
     const string& filename, 
     const vector<string>& toxic_patterns, 
     int max_edits) {
     
-    vector<XMLMessageResult> results;
-    ifstream file(filename);
+    XMLAnalysisSummary summary;
+    MappedFile mapped(filename);
+    ifstream file;
+    if (!mapped.is_mapped()) {
+        file.open(filename, ios::binary);  // pipes and other unmappable input
+        if (!file.is_open()) {
+            cout << RED << "Failed to open XML file\n" << RESET;
+            return summary;
+        }
+    }
+    
+    cout << "\n" << CYAN << "=== XML DOCUMENT ANALYSIS RESULTS ===\n" << RESET;
+    cout << "File analyzed with " << toxic_patterns.size() << " toxic pattern(s)\n";
+    cout << "Max edit distance: " << max_edits << "\n";
     
-    if (!file.is_open()) {
-        cout << RED << "Failed to open XML file\n" << RESET;
-        return results;
+    // The exact matcher is shared read-only by the analysis tasks
+    if (!exact_pattern_matcher || exact_matcher_patterns != toxic_patterns) {
+        exact_pattern_matcher = make_unique<AhoCorasick>(toxic_patterns, true);
+        exact_matcher_patterns = toxic_patterns;
     }
     
-    string line;
-    string current_text;
-    bool in_text_tag = false;
-    int message_count = 0;
-    
-    // Simple XML parser for <text> content
-    while (getline(file, line)) {
-        // Find <text> tags
-        size_t text_start = line.find("<text>");
-        if (text_start != string::npos) {
-            size_t text_end = line.find("</text>", text_start);
-            if (text_end != string::npos) {
-                // Extract text content
-                string text_content = line.substr(text_start + 6, text_end - text_start - 6);
-                
-                if (!text_content.empty()) {
-                    XMLMessageResult result;
-                    result.text = text_content;
-                    
-                    // Perform comprehensive analysis (like Option 3)
-                    analyze_message_content(result, text_content, toxic_patterns, max_edits);
-                    
-                    results.push_back(result);
-                    message_count++;
-                    
-                    // Show progress for large files
-                    if (message_count % 10 == 0) {
-                        cout << GREEN << "Processed " << message_count << " messages...\n" << RESET;
-                    }
-                }
+    // One approximate matcher per pool worker, plus one for this thread
+    WorkStealingPool& pool = WorkStealingPool::global();
+    while (content_matchers.size() < pool.size() + 1) {
+        content_matchers.push_back(make_unique<ApproximateMatcher>(false));
+    }
+    
+    // Messages are analyzed as pool tasks, in parallel, but retired (counted
+    // and shown) strictly in document order. At most
+    // XML_MESSAGES_IN_FLIGHT are held at once, so memory still does not
+    // grow with the file. Slots are reused in ring order and keep their
+    // buffers, and a task captures only its slot (small enough for
+    // std::function to store inline), so a message allocates nothing.
+    struct PendingMessage {
+        XMLMessageResult result;
+        atomic<bool> done{false};
+        ChatModerationUI* owner;
+        const vector<string>* patterns;
+        int max_edits;
+    };
+    vector<unique_ptr<PendingMessage>> slots(XML_MESSAGES_IN_FLIGHT + 1);
+    size_t head = 0;
+    size_t in_flight = 0;
+    TaskGroup group(pool);
+    uint64_t allocations_before = alloc_counter::total_allocations();
+    
+    auto retire = [&](size_t keep) {
+        while (in_flight > 0) {
+            PendingMessage& front = *slots[head];
+            if (!front.done.load(memory_order_acquire)) {
+                if (in_flight <= keep) break;
+                if (!pool.run_one()) this_thread::yield();  // help instead of idling
+                continue;
             }
+            
+            summary.add(front.result);
+            if (front.result.has_toxic_content) {
+                display_xml_message(front.result, summary.total_messages);
+            }
+            
+            // Show progress for large files
+            if (summary.total_messages % 10 == 0) {
+                cout << GREEN << "Processed " << summary.total_messages << " messages...\n" << RESET;
+            }
+            head = (head + 1) % slots.size();
+            in_flight--;
+        }
+    };
+    
+    // Markdown formatting of the message being read, checked piece by
+    // piece as its text streams in instead of rescanned once complete
+    PDAStreamState formatting;
+    
+    // Stream the document: each message is analyzed, shown if toxic and
+    // counted, then dropped
+    XMLStreamReader reader([&](const XMLChatMessage& message) {
+        const bool valid_formatting = formatting.finish();
+        if (message.text.empty()) {
+            formatting.reset();
+            return;
+        }
+        
+        unique_ptr<PendingMessage>& pending = slots[(head + in_flight) % slots.size()];
+        if (!pending) {
+            pending = make_unique<PendingMessage>();
+            pending->owner = this;
+            pending->patterns = &toxic_patterns;
+            pending->max_edits = max_edits;
         }
+        PendingMessage* slot = pending.get();
+        slot->result.clear();
+        slot->result.text = message.text;
+        slot->result.user = message.user;
+        slot->result.timestamp = message.timestamp;
+        slot->result.valid_formatting = valid_formatting;
+        slot->result.formatting_error = formatting.error_message();
+        formatting.reset();
+        slot->done.store(false, memory_order_relaxed);
+        in_flight++;
+        
+        group.run([slot] {
+            try {
+                slot->owner->analyze_message_content(slot->result, slot->result.text,
+                                                     *slot->patterns, slot->max_edits);
+            } catch (...) {
+                slot->done.store(true, memory_order_release);
+                throw;
+            }
+            slot->done.store(true, memory_order_release);
+        });
+        
+        retire(XML_MESSAGES_IN_FLIGHT);
+    });
+    reader.set_text_callback([&](string_view piece) { formatting.feed(piece); });
+    if (mapped.is_mapped()) {
+        reader.feed(mapped.view());
+        reader.finish();
+    } else {
+        reader.read_all(file);
+    }
+    group.wait();
+    retire(0);
+    
+    cout << GREEN << " Parsed " << summary.total_messages << " messages from XML\n" << RESET;
+    print_pattern_cache_stats();
+    if (alloc_counter::enabled() && summary.total_messages > 0) {
+        uint64_t allocations = alloc_counter::total_allocations() - allocations_before;
+        cout << "Heap allocations: " << allocations << " (" << fixed << setprecision(2)
+             << (static_cast<double>(allocations) / summary.total_messages) << " per message)\n";
     }
+    return summary;
+}
+
+// Approximate matcher owned by the calling thread (pool worker or not)
+ApproximateMatcher& ChatModerationUI::thread_content_matcher() {
+    int index = WorkStealingPool::global().worker_index();
+    return *content_matchers[index >= 0 ? index : content_matchers.size() - 1];
+}
+
+// Check one bracket's content against the patterns
+void ChatModerationUI::check_bracket_content(
+    BracketContent& bc,
+    string_view text,
+    const vector<string>& toxic_patterns,
+    int max_edits) {
     
-    file.close();
-    cout << GREEN << " Parsed " << message_count << " messages from XML\n" << RESET;
-    return results;
+    ApproximateMatcher& matcher = thread_content_matcher();
+    string_view content = bc.content(text);
+    bc.is_toxic = false;
+    bc.matched_pattern.clear();
+    bc.edit_distance = -1;
+    
+    for (const auto& pattern : toxic_patterns) {
+        // Exact match, then approximate match
+        int distance = content.find(pattern) != string_view::npos
+                           ? 0
+                           : matcher.first_match_distance(content, pattern, max_edits);
+        if (distance >= 0) {
+            bc.is_toxic = true;
+            bc.matched_pattern = pattern;
+            bc.edit_distance = distance;
+            break;
+        }
+    }
 }
 
-// Function to analyze message content (like Option 3)
+// Function to analyze message content (like Option 3); runs as a pool
+// task, so it only reads shared state and uses this thread's matcher
 void ChatModerationUI::analyze_message_content(
     XMLMessageResult& result,
     const string& text,
     const vector<string>& toxic_patterns,
     int max_edits) {
     
-    ApproximateMatcher matcher(false);
+    ApproximateMatcher& matcher = thread_content_matcher();
     result.toxicity_score = 0;
     result.has_toxic_content = false;
     
-    // 1. EXACT MATCHES (NFA/DFA style)
-    string lower_text = text;
-    transform(lower_text.begin(), lower_text.end(), lower_text.begin(), ::tolower);
-    
-    for (const auto& pattern : toxic_patterns) {
-        string lower_pattern = pattern;
-        transform(lower_pattern.begin(), lower_pattern.end(), lower_pattern.begin(), ::tolower);
-        
-        // Simple exact match search
-        if (lower_text.find(lower_pattern) != string::npos) {
-            result.exact_matches.push_back(pattern);
-            result.has_toxic_content = true;
-            result.toxicity_score += 20;
-        }
+    // Scratch for this message lives on the thread's arena
+    ScratchScope scope;
+    
+    // 1. EXACT MATCHES (Aho-Corasick, case folded in the automaton)
+    // One scan finds every pattern, reported in pattern order
+    pmr::vector<char> seen(toxic_patterns.size(), 0, scope.resource());
+    exact_pattern_matcher->scan(text, [&](int id, size_t) { seen[id] = 1; });
+    for (size_t id = 0; id < seen.size(); id++) {
+        if (!seen[id]) continue;
+        result.exact_matches.push_back(toxic_patterns[id]);
+        result.has_toxic_content = true;
+        result.toxicity_score += 20;
     }
     
-    // 2. APPROXIMATE MATCHES
-    for (const auto& pattern : toxic_patterns) {
-        auto matches = matcher.find_matches(text, pattern, max_edits);
-        for (const auto& match : matches) {
-            // Avoid duplicates with exact matches
-            bool already_found = false;
-            for (const auto& exact : result.exact_matches) {
-                if (exact == match.matched_pattern) {
-                    already_found = true;
-                    break;
-                }
-            }
-            if (!already_found) {
-                result.approx_matches.push_back({match.original, match.matched_pattern});
-                result.has_toxic_content = true;
-                result.toxicity_score += 10;
+    // 2. APPROXIMATE MATCHES (all patterns in one pass, pattern-major order)
+    auto approx = matcher.find_matches(text, toxic_patterns, max_edits);
+    for (const auto& match : approx) {
+        // Avoid duplicates with exact matches
+        bool already_found = false;
+        for (const auto& exact : result.exact_matches) {
+            if (exact == match.matched_pattern) {
+                already_found = true;
+                break;
             }
         }
+        if (!already_found) {
+            result.approx_matches.push_back({match.original, match.matched_pattern});
+            result.has_toxic_content = true;
+            result.toxicity_score += 10;
+        }
     }
     
     // 3. BRACKET STRUCTURE ANALYSIS (PDA style)
-    stack<pair<size_t, char>> bracket_stack;
+    pmr::vector<pair<size_t, char>> bracket_stack(scope.resource());
     
     for (size_t i = 0; i < text.length(); i++) {
         char c = text[i];
         
         if (c == '(' || c == '[' || c == '{' || c == '<') {
-            bracket_stack.push({i, c});
+            bracket_stack.push_back({i, c});
         } 
         else if (c == ')' || c == ']' || c == '}' || c == '>') {
             if (!bracket_stack.empty()) {
-                auto [start_idx, open_type] = bracket_stack.top();
-                bracket_stack.pop();
+                auto [start_idx, open_type] = bracket_stack.back();
+                bracket_stack.pop_back();
                 
                 // Check if brackets match
                 bool matches = false;
@@ -1297,166 +1479,154 @@ void ChatModerationUI::analyze_message_content(
                 else if (open_type == '<' && c == '>') { matches = true; close_bracket = '>'; }
                 
                 if (matches) {
-                    string content = text.substr(start_idx + 1, i - start_idx - 1);
-                    
-                    // Check if content contains toxic patterns
-                    bool is_toxic = false;
-                    string matched_pattern;
-                    int edit_distance = INT_MAX;
-                    
-                    for (const auto& pattern : toxic_patterns) {
-                        // Exact match
-                        if (content.find(pattern) != string::npos) {
-                            is_toxic = true;
-                            matched_pattern = pattern;
-                            edit_distance = 0;
-                            break;
-                        }
-                        
-                        // Approximate match
-                        auto matches = matcher.find_matches(content, pattern, max_edits);
-                        if (!matches.empty()) {
-                            is_toxic = true;
-                            matched_pattern = pattern;
-                            edit_distance = min(edit_distance, matches[0].distance);
-                            break;
-                        }
-                    }
-                    
                     BracketContent bc;
                     bc.open_bracket = open_type;
                     bc.close_bracket = close_bracket;
-                    bc.content = content;
-                    bc.is_toxic = is_toxic;
-                    bc.matched_pattern = matched_pattern;
-                    bc.edit_distance = (edit_distance == INT_MAX) ? -1 : edit_distance;
-                    
+                    bc.content_offset = start_idx + 1;
+                    bc.content_length = i - start_idx - 1;
+                    bc.is_toxic = false;
+                    bc.edit_distance = -1;
                     result.bracket_contents.push_back(bc);
-                    
-                    if (is_toxic) {
-                        result.has_toxic_content = true;
-                        result.toxicity_score += 30;
-                    }
                 }
             }
         }
     }
     
+    // Each bracket is checked against every pattern, so a bracket-heavy
+    // message fans its checks out as nested tasks for idle workers to steal
+    if (result.bracket_contents.size() > 1) {
+        // Check arguments go on the arena so each task captures a single
+        // pointer, which std::function stores without a heap allocation
+        struct BracketCheck {
+            ChatModerationUI* ui;
+            BracketContent* bracket;
+            string_view text;
+            const vector<string>* patterns;
+            int max_edits;
+        };
+        pmr::vector<BracketCheck> checks(scope.resource());
+        checks.reserve(result.bracket_contents.size());
+        for (auto& bc : result.bracket_contents) {
+            checks.push_back({this, &bc, text, &toxic_patterns, max_edits});
+        }
+        
+        TaskGroup brackets;
+        for (BracketCheck& check : checks) {
+            brackets.run([c = &check] {
+                c->ui->check_bracket_content(*c->bracket, c->text, *c->patterns, c->max_edits);
+            });
+        }
+        brackets.wait();
+    } else if (!result.bracket_contents.empty()) {
+        check_bracket_content(result.bracket_contents[0], text, toxic_patterns, max_edits);
+    }
+    
+    for (const auto& bc : result.bracket_contents) {
+        if (bc.is_toxic) {
+            result.has_toxic_content = true;
+            result.toxicity_score += 30;
+        }
+    }
+    
     // Cap toxicity score
     if (result.toxicity_score > 100) result.toxicity_score = 100;
 }
 
-// Function to display XML analysis
-void ChatModerationUI::display_xml_analysis(
-    const vector<XMLMessageResult>& results,
-    const vector<string>& toxic_patterns,
-    int max_edits) {
+// Function to display one toxic XML message
+void ChatModerationUI::display_xml_message(const XMLMessageResult& msg, size_t index) {
+    cout << MAGENTA << "\n--- TOXIC MESSAGE #" << index << " ---\n" << RESET;
+    if (!msg.user.empty()) cout << "User: " << msg.user << "\n";
+    if (!msg.timestamp.empty()) cout << "Time: " << msg.timestamp << "\n";
+    cout << "Text: \"" << msg.text << "\"\n";
+    cout << "Toxicity Score: ";
+    
+    if (msg.toxicity_score >= 70) {
+        cout << RED << msg.toxicity_score << "/100 (HIGH)\n" << RESET;
+    } else if (msg.toxicity_score >= 30) {
+        cout << YELLOW << msg.toxicity_score << "/100 (MODERATE)\n" << RESET;
+    } else {
+        cout << YELLOW << msg.toxicity_score << "/100 (LOW)\n" << RESET;
+    }
     
-    cout << "\n" << CYAN << "=== XML DOCUMENT ANALYSIS RESULTS ===\n" << RESET;
-    cout << "File analyzed with " << toxic_patterns.size() << " toxic pattern(s)\n";
-    cout << "Max edit distance: " << max_edits << "\n";
-    cout << "Total messages analyzed: " << results.size() << "\n\n";
-    
-    int toxic_messages = 0;
-    int clean_messages = 0;
-    int total_exact = 0;
-    int total_approx = 0;
-    int total_toxic_brackets = 0;
-    int total_brackets = 0;
-    
-    // Display each toxic message
-    for (size_t i = 0; i < results.size(); i++) {
-        const auto& msg = results[i];
+    // Exact matches
+    if (!msg.exact_matches.empty()) {
+        cout << RED << "Exact matches: ";
+        for (size_t j = 0; j < msg.exact_matches.size(); j++) {
+            cout << msg.exact_matches[j];
+            if (j < msg.exact_matches.size() - 1) cout << ", ";
+        }
+        cout << RESET << "\n";
+    }
+    
+    // Approximate matches
+    if (!msg.approx_matches.empty()) {
+        cout << YELLOW << "Approximate matches: ";
+        for (size_t j = 0; j < msg.approx_matches.size(); j++) {
+            cout << msg.approx_matches[j].first << "->" << msg.approx_matches[j].second;
+            if (j < msg.approx_matches.size() - 1) cout << ", ";
+        }
+        cout << RESET << "\n";
+    }
+    
+    // Bracket analysis
+    if (!msg.bracket_contents.empty()) {
+        cout << CYAN << "Bracket structures: " << msg.bracket_contents.size() << "\n" << RESET;
         
-        if (msg.has_toxic_content) {
-            toxic_messages++;
-            
-            cout << MAGENTA << "\n--- TOXIC MESSAGE #" << (i+1) << " ---\n" << RESET;
-            cout << "Text: \"" << msg.text << "\"\n";
-            cout << "Toxicity Score: ";
-            
-            if (msg.toxicity_score >= 70) {
-                cout << RED << msg.toxicity_score << "/100 (HIGH)\n" << RESET;
-            } else if (msg.toxicity_score >= 30) {
-                cout << YELLOW << msg.toxicity_score << "/100 (MODERATE)\n" << RESET;
+        for (const auto& bc : msg.bracket_contents) {
+            if (bc.is_toxic) {
+                cout << RED << "  TOXIC: " << bc.open_bracket << bc.content(msg.text) << bc.close_bracket;
+                cout << " (matches: " << bc.matched_pattern;
+                if (bc.edit_distance > 0) cout << ", " << bc.edit_distance << " edit";
+                if (bc.edit_distance > 1) cout << "s";
+                cout << ")\n" << RESET;
             } else {
-                cout << YELLOW << msg.toxicity_score << "/100 (LOW)\n" << RESET;
+                cout << GREEN << "  CLEAN: " << bc.open_bracket << bc.content(msg.text) << bc.close_bracket << "\n" << RESET;
             }
-            
-            // Exact matches
-            if (!msg.exact_matches.empty()) {
-                cout << RED << "Exact matches: ";
-                for (size_t j = 0; j < msg.exact_matches.size(); j++) {
-                    cout << msg.exact_matches[j];
-                    if (j < msg.exact_matches.size() - 1) cout << ", ";
-                }
-                cout << RESET << "\n";
-                total_exact += msg.exact_matches.size();
-            }
-            
-            // Approximate matches
-            if (!msg.approx_matches.empty()) {
-                cout << YELLOW << "Approximate matches: ";
-                for (size_t j = 0; j < msg.approx_matches.size(); j++) {
-                    cout << msg.approx_matches[j].first << "->" << msg.approx_matches[j].second;
-                    if (j < msg.approx_matches.size() - 1) cout << ", ";
-                }
-                cout << RESET << "\n";
-                total_approx += msg.approx_matches.size();
-            }
-            
-            // Bracket analysis
-            if (!msg.bracket_contents.empty()) {
-                cout << CYAN << "Bracket structures: " << msg.bracket_contents.size() << "\n" << RESET;
-                total_brackets += msg.bracket_contents.size();
-                
-                for (const auto& bc : msg.bracket_contents) {
-                    if (bc.is_toxic) {
-                        cout << RED << "  TOXIC: " << bc.open_bracket << bc.content << bc.close_bracket;
-                        cout << " (matches: " << bc.matched_pattern;
-                        if (bc.edit_distance > 0) cout << ", " << bc.edit_distance << " edit";
-                        if (bc.edit_distance > 1) cout << "s";
-                        cout << ")\n" << RESET;
-                        total_toxic_brackets++;
-                    } else {
-                        cout << GREEN << "  CLEAN: " << bc.open_bracket << bc.content << bc.close_bracket << "\n" << RESET;
-                    }
-                }
-            }
-            
-            cout << string(50, '-') << "\n";
-        } else {
-            clean_messages++;
         }
     }
     
+    if (!msg.valid_formatting) {
+        cout << YELLOW << "Formatting: INVALID (" << msg.formatting_error << ")\n" << RESET;
+    }
+    
+    cout << string(50, '-') << "\n";
+}
+
+// Function to display XML analysis
+void ChatModerationUI::display_xml_analysis(
+    const XMLAnalysisSummary& summary,
+    const vector<string>& toxic_patterns,
+    int max_edits) {
+    
     // SUMMARY
     cout << "\n" << BLUE << "=== ANALYSIS SUMMARY ===\n" << RESET;
-    cout << "Total messages: " << results.size() << "\n";
-    cout << "Toxic messages: " << RED << toxic_messages << RESET << "\n";
-    cout << "Clean messages: " << GREEN << clean_messages << RESET << "\n";
+    cout << "Patterns: " << toxic_patterns.size() << ", max edit distance: " << max_edits << "\n";
+    cout << "Total messages: " << summary.total_messages << "\n";
+    cout << "Toxic messages: " << RED << summary.toxic_messages << RESET << "\n";
+    cout << "Clean messages: " << GREEN << summary.clean_messages << RESET << "\n";
     
-    if (results.size() > 0) {
-        double toxic_percent = (toxic_messages * 100.0) / results.size();
+    if (summary.total_messages > 0) {
+        double toxic_percent = (summary.toxic_messages * 100.0) / summary.total_messages;
         cout << "Toxicity rate: " 
              << (toxic_percent > 50 ? RED : toxic_percent > 20 ? YELLOW : GREEN)
              << fixed << setprecision(1) << toxic_percent << "%\n" << RESET;
     }
     
-    cout << "Total exact matches: " << RED << total_exact << RESET << "\n";
-    cout << "Total approximate matches: " << YELLOW << total_approx << RESET << "\n";
-    cout << "Total bracket structures: " << total_brackets << "\n";
-    cout << "Toxic brackets: " << RED << total_toxic_brackets << RESET << "\n";
+    cout << "Total exact matches: " << RED << summary.total_exact << RESET << "\n";
+    cout << "Total approximate matches: " << YELLOW << summary.total_approx << RESET << "\n";
+    cout << "Total bracket structures: " << summary.total_brackets << "\n";
+    cout << "Toxic brackets: " << RED << summary.total_toxic_brackets << RESET << "\n";
+    cout << "Messages with broken formatting: " << YELLOW << summary.broken_formatting << RESET << "\n";
     
     // RECOMMENDATIONS
     cout << "\n" << CYAN << "=== MODERATION RECOMMENDATIONS ===\n" << RESET;
-    if (toxic_messages > results.size() / 2) {
+    if (summary.toxic_messages > summary.total_messages / 2) {
         cout << RED << "CRITICAL: More than 50% of messages are toxic!\n" << RESET;
         cout << "  Consider: Banning users, enabling strict filtering\n";
-    } else if (toxic_messages > results.size() / 4) {
+    } else if (summary.toxic_messages > summary.total_messages / 4) {
         cout << YELLOW << "WARNING: Significant toxicity detected (25-50%)\n" << RESET;
         cout << "  Consider: Warnings, temporary mutes, content review\n";
-    } else if (toxic_messages > 0) {
+    } else if (summary.toxic_messages > 0) {
         cout << YELLOW << "MODERATE: Some toxic content found\n" << RESET;
         cout << "  Consider: Flagging specific messages for review\n";
     } else {
@@ -1496,14 +1666,13 @@ if (!viz_choice.empty() && tolower(viz_choice[0]) == 'y') {
     // Map 4 to 5 since we removed statistics
     if (diagram_choice == 4) diagram_choice = 5;
     
-    generate_xml_analysis_diagrams(results, toxic_patterns, diagram_choice);
+    generate_xml_analysis_diagrams(toxic_patterns, diagram_choice);
 }
 }
 
 
 // Function to generate diagrams for XML analysis
 void ChatModerationUI::generate_xml_analysis_diagrams(
-    const vector<XMLMessageResult>& results,
     const vector<string>& toxic_patterns,
     int diagram_type) {
     
@@ -1523,6 +1692,7 @@ void ChatModerationUI::generate_xml_analysis_diagrams(
         // Generate NFA and DFA for the patterns
         NFA toxic_nfa = RegexToNFA::from_regex(regex_pattern);
         DFA toxic_dfa = convert_nfa_to_dfa(toxic_nfa);
+        minimize(toxic_dfa);
         
         // Create PDA for bracket analysis
         PDA pda = BracketPDA::create_toxic_detection_pda(toxic_patterns, 1);
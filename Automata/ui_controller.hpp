@@ -6,8 +6,10 @@
 #include "nfa_engine.hpp"      // ADD THIS
 #include "dfa_engine.hpp"      // ADD THIS
 #include "pda_engine.hpp"      // ADD THIS
+#include "aho_corasick.hpp"
 #include <iostream>
 #include <string>
+#include <string_view>
 #include <vector>
 #include <fstream>
 #include <utility>
@@ -18,22 +20,59 @@
 struct BracketContent {
     char open_bracket;
     char close_bracket;
-    std::string content;
+    size_t content_offset;  // content is a range of the message text,
+    size_t content_length;  // so finding a bracket copies nothing
     bool is_toxic;
     std::string matched_pattern;
     int edit_distance;
+
+    std::string_view content(std::string_view text) const {
+        return text.substr(content_offset, content_length);
+    }
 };
 
 struct XMLMessageResult {
+    std::string user;
+    std::string timestamp;
     std::string text;
     std::vector<std::string> exact_matches;
     std::vector<std::pair<std::string, std::string>> approx_matches;
     std::vector<BracketContent> bracket_contents;
     bool has_toxic_content;
     int toxicity_score;
+    bool valid_formatting = true;     // markdown structure, as PDA::simulate_markdown() sees it
+    std::string formatting_error;     // its message when invalid
     
     XMLMessageResult() : has_toxic_content(false), toxicity_score(0) {}
     explicit XMLMessageResult(const std::string& t) : text(t), has_toxic_content(false), toxicity_score(0) {}
+
+    // Reset for reuse; strings and vectors keep their capacity
+    void clear() {
+        user.clear();
+        timestamp.clear();
+        text.clear();
+        exact_matches.clear();
+        approx_matches.clear();
+        bracket_contents.clear();
+        has_toxic_content = false;
+        toxicity_score = 0;
+        valid_formatting = true;
+        formatting_error.clear();
+    }
+};
+
+// Running totals for an XML analysis; messages are not kept once counted
+struct XMLAnalysisSummary {
+    size_t total_messages = 0;
+    size_t toxic_messages = 0;
+    size_t clean_messages = 0;
+    size_t total_exact = 0;
+    size_t total_approx = 0;
+    size_t total_brackets = 0;
+    size_t total_toxic_brackets = 0;
+    size_t broken_formatting = 0;
+
+    void add(const XMLMessageResult& result);
 };
 
 class ChatModerationUI {
@@ -41,6 +80,18 @@ private:
     ToxicityAnalyzer analyzer;
     ChatLogAnalyzer log_analyzer;
 
+    // Case-insensitive Aho-Corasick over the current toxic pattern list,
+    // rebuilt only when the list changes
+    std::unique_ptr<AhoCorasick> exact_pattern_matcher;
+    std::vector<std::string> exact_matcher_patterns;
+
+    // Quiet matchers for XML message analysis, one per pool worker plus
+    // one for the UI thread; each keeps its compiled patterns across messages
+    std::vector<std::unique_ptr<ApproximateMatcher>> content_matchers;
+
+    // Messages analyzed ahead of the one being displayed
+    static constexpr size_t XML_MESSAGES_IN_FLIGHT = 1024;
+
     // Color constants
     static constexpr const char* RED = "\033[31m";
     static constexpr const char* GREEN = "\033[32m";
@@ -66,9 +117,10 @@ private:
     std::vector<std::string> extract_patterns_from_regex(const std::string& regex);
     std::vector<std::string> parse_simple_regex(const std::string& regex);
     std::string get_current_timestamp();
+    void print_pattern_cache_stats();
 
     // XML Analysis functions
-    std::vector<XMLMessageResult> parse_and_analyze_xml(
+    XMLAnalysisSummary parse_and_analyze_xml(
         const std::string& filename, 
         const std::vector<std::string>& toxic_patterns, 
         int max_edits = 2);
@@ -79,13 +131,22 @@ private:
         const std::vector<std::string>& toxic_patterns,
         int max_edits = 2);
     
+    ApproximateMatcher& thread_content_matcher();
+
+    void check_bracket_content(
+        BracketContent& bc,
+        std::string_view text,
+        const std::vector<std::string>& toxic_patterns,
+        int max_edits);
+    
+    void display_xml_message(const XMLMessageResult& msg, size_t index);
+
     void display_xml_analysis(
-        const std::vector<XMLMessageResult>& results,
+        const XMLAnalysisSummary& summary,
         const std::vector<std::string>& toxic_patterns,
         int max_edits = 2);
     
     void generate_xml_analysis_diagrams(
-        const std::vector<XMLMessageResult>& results,
         const std::vector<std::string>& toxic_patterns,
         int diagram_type = 4);
 
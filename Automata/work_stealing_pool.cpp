@@ -0,0 +1,173 @@
+#include "work_stealing_pool.hpp"
+#include <algorithm>
+#include <chrono>
+
+namespace {
+    // Which pool (if any) the current thread works for
+    thread_local const WorkStealingPool* current_pool = nullptr;
+    thread_local int current_index = -1;
+
+    constexpr int YIELD_SPINS = 64;  // waiter spins before it starts sleeping
+}
+
+// ==================== POOL ====================
+
+WorkStealingPool::WorkStealingPool(unsigned count) {
+    if (count == 0) count = std::max(1u, std::thread::hardware_concurrency());
+    for (unsigned i = 0; i < count; i++) {
+        deques.push_back(std::make_unique<TaskDeque>());
+    }
+    for (unsigned i = 0; i < count; i++) {
+        threads.emplace_back([this, i] { worker_loop(static_cast<int>(i)); });
+    }
+}
+
+WorkStealingPool::~WorkStealingPool() {
+    {
+        std::lock_guard<std::mutex> lock(sleep_mutex);
+        stopping = true;
+    }
+    wake.notify_all();
+    for (auto& t : threads) t.join();
+}
+
+WorkStealingPool& WorkStealingPool::global() {
+    static WorkStealingPool pool;
+    return pool;
+}
+
+int WorkStealingPool::worker_index() const {
+    return current_pool == this ? current_index : -1;
+}
+
+void WorkStealingPool::submit(Task task) {
+    int self = worker_index();
+    TaskDeque& target = self >= 0 ? *deques[self] : injected;
+    {
+        std::lock_guard<std::mutex> lock(target.mutex);
+        target.push_back(std::move(task));
+    }
+    queued.fetch_add(1);
+
+    // A sleeper registers before re-checking queued, so either it sees
+    // this task or we see it (both sides are seq_cst)
+    if (sleepers.load() > 0) {
+        std::lock_guard<std::mutex> lock(sleep_mutex);
+        wake.notify_one();
+    }
+}
+
+bool WorkStealingPool::run_one() {
+    int self = worker_index();
+    Task task;
+    bool found = self >= 0 ? pop_back(*deques[self], task) || steal(self, task)
+                           : pop_front(injected, task) || steal(self, task);
+    if (!found) return false;
+    task();
+    return true;
+}
+
+// ------------------ deque access ------------------
+
+void WorkStealingPool::TaskDeque::push_back(Task task) {
+    if (count == ring.size()) {
+        std::vector<Task> grown(std::max<size_t>(16, ring.size() * 2));
+        for (size_t i = 0; i < count; i++) {
+            grown[i] = std::move(ring[(head + i) & (ring.size() - 1)]);
+        }
+        ring = std::move(grown);
+        head = 0;
+    }
+    ring[(head + count) & (ring.size() - 1)] = std::move(task);
+    count++;
+}
+
+WorkStealingPool::Task WorkStealingPool::TaskDeque::take_back() {
+    count--;
+    Task& slot = ring[(head + count) & (ring.size() - 1)];
+    Task task = std::move(slot);
+    slot = nullptr;
+    return task;
+}
+
+WorkStealingPool::Task WorkStealingPool::TaskDeque::take_front() {
+    Task& slot = ring[head];
+    Task task = std::move(slot);
+    slot = nullptr;
+    head = (head + 1) & (ring.size() - 1);
+    count--;
+    return task;
+}
+
+bool WorkStealingPool::pop_back(TaskDeque& deque, Task& out) {
+    std::lock_guard<std::mutex> lock(deque.mutex);
+    if (deque.empty()) return false;
+    out = deque.take_back();
+    queued.fetch_sub(1);
+    return true;
+}
+
+bool WorkStealingPool::pop_front(TaskDeque& deque, Task& out) {
+    std::lock_guard<std::mutex> lock(deque.mutex);
+    if (deque.empty()) return false;
+    out = deque.take_front();
+    queued.fetch_sub(1);
+    return true;
+}
+
+bool WorkStealingPool::steal(int thief, Task& out) {
+    // Start after the thief so workers spread over different victims
+    size_t n = deques.size();
+    size_t start = thief >= 0 ? static_cast<size_t>(thief) + 1 : 0;
+    for (size_t k = 0; k < n; k++) {
+        size_t victim = (start + k) % n;
+        if (static_cast<int>(victim) == thief) continue;
+        if (pop_front(*deques[victim], out)) return true;
+    }
+    return false;
+}
+
+// ------------------ worker ------------------
+
+void WorkStealingPool::worker_loop(int index) {
+    current_pool = this;
+    current_index = index;
+
+    for (;;) {
+        Task task;
+        if (pop_back(*deques[index], task) || pop_front(injected, task) || steal(index, task)) {
+            task();
+            continue;
+        }
+
+        std::unique_lock<std::mutex> lock(sleep_mutex);
+        sleepers.fetch_add(1);
+        wake.wait(lock, [this] { return stopping || queued.load() > 0; });
+        sleepers.fetch_sub(1);
+        if (stopping && queued.load() == 0) return;
+    }
+}
+
+// ==================== TASK GROUP ====================
+
+void TaskGroup::wait_all() {
+    for (int spins = 0; pending.load(std::memory_order_acquire) != 0;) {
+        if (pool.run_one()) {
+            spins = 0;
+        } else if (++spins < YIELD_SPINS) {
+            std::this_thread::yield();
+        } else {
+            // Remaining tasks are running elsewhere; don't spin on them
+            std::this_thread::sleep_for(std::chrono::microseconds(50));
+        }
+    }
+}
+
+void TaskGroup::wait() {
+    wait_all();
+    std::lock_guard<std::mutex> lock(error_mutex);
+    if (error) {
+        std::exception_ptr e = std::exchange(error, nullptr);
+        std::rethrow_exception(e);
+    }
+}
@@ -0,0 +1,138 @@
+#ifndef WORK_STEALING_POOL_HPP
+#define WORK_STEALING_POOL_HPP
+
+#include <atomic>
+#include <condition_variable>
+#include <exception>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <utility>
+#include <vector>
+
+/**
+ * @class WorkStealingPool
+ * @brief Thread pool with one task deque per worker
+ *
+ * A worker pushes the tasks it spawns onto the back of its own deque and
+ * pops from the back (newest first, cache-warm). When its deque is empty
+ * it takes tasks submitted from outside the pool, then steals from the
+ * front (oldest, usually the largest work) of the other workers' deques.
+ * Expensive tasks therefore never hold up a fixed share of the work: any
+ * idle worker takes over whatever is still queued.
+ */
+class WorkStealingPool {
+public:
+    using Task = std::function<void()>;
+
+    /**
+     * @param threads Worker threads; 0 uses one per hardware thread
+     */
+    explicit WorkStealingPool(unsigned threads = 0);
+
+    /**
+     * @brief Runs every queued task, then joins the workers
+     */
+    ~WorkStealingPool();
+
+    WorkStealingPool(const WorkStealingPool&) = delete;
+    WorkStealingPool& operator=(const WorkStealingPool&) = delete;
+
+    /**
+     * @brief Process-wide pool
+     */
+    static WorkStealingPool& global();
+
+    void submit(Task task);
+
+    /**
+     * @brief Run one queued task on the calling thread, if there is one
+     *
+     * Workers look at their own deque and then steal; other threads take
+     * externally submitted tasks first. Used by waiters to help instead of
+     * blocking.
+     */
+    bool run_one();
+
+    unsigned size() const { return static_cast<unsigned>(threads.size()); }
+
+    /**
+     * @brief Index of the calling worker thread, or -1 outside this pool
+     */
+    int worker_index() const;
+
+private:
+    // Double-ended ring of tasks. Unlike std::deque it keeps its storage
+    // once grown, so steady-state push/pop does not touch the heap.
+    struct TaskDeque {
+        std::mutex mutex;
+        std::vector<Task> ring;  // size is zero or a power of two
+        size_t head = 0;
+        size_t count = 0;
+
+        bool empty() const { return count == 0; }
+        void push_back(Task task);
+        Task take_back();
+        Task take_front();
+    };
+
+    std::vector<std::unique_ptr<TaskDeque>> deques;  // one per worker
+    TaskDeque injected;                              // submitted from outside
+    std::vector<std::thread> threads;
+
+    std::atomic<size_t> queued{0};
+    std::atomic<unsigned> sleepers{0};
+    std::mutex sleep_mutex;
+    std::condition_variable wake;
+    bool stopping = false;
+
+    bool pop_back(TaskDeque& deque, Task& out);
+    bool pop_front(TaskDeque& deque, Task& out);
+    bool steal(int thief, Task& out);
+    void worker_loop(int index);
+};
+
+/**
+ * @class TaskGroup
+ * @brief Fork/join scope over a WorkStealingPool
+ *
+ * run() spawns a task; wait() returns once every task spawned through the
+ * group has finished, running queued tasks itself in the meantime, so
+ * groups nest freely inside pool tasks without tying up a worker. The
+ * first exception thrown by a task is rethrown from wait().
+ */
+class TaskGroup {
+public:
+    explicit TaskGroup(WorkStealingPool& pool = WorkStealingPool::global()) : pool(pool) {}
+    ~TaskGroup() { wait_all(); }
+
+    TaskGroup(const TaskGroup&) = delete;
+    TaskGroup& operator=(const TaskGroup&) = delete;
+
+    template <typename F>
+    void run(F&& f) {
+        pending.fetch_add(1, std::memory_order_relaxed);
+        pool.submit([this, task = std::forward<F>(f)]() mutable {
+            try {
+                task();
+            } catch (...) {
+                std::lock_guard<std::mutex> lock(error_mutex);
+                if (!error) error = std::current_exception();
+            }
+            pending.fetch_sub(1, std::memory_order_release);
+        });
+    }
+
+    void wait();
+
+private:
+    WorkStealingPool& pool;
+    std::atomic<size_t> pending{0};
+    std::mutex error_mutex;
+    std::exception_ptr error;
+
+    void wait_all();
+};
+
+#endif // WORK_STEALING_POOL_HPP
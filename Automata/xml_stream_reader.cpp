@@ -0,0 +1,352 @@
+#include "xml_stream_reader.hpp"
+#include <vector>
+#include <cctype>
+#include <cstdint>
+#include <cstdlib>
+
+namespace {
+    constexpr size_t MAX_NAME_BYTES = 64;    // longer tag names are truncated
+    constexpr size_t MAX_ENTITY_BYTES = 16;  // longer "entities" are kept literally
+    constexpr size_t MAX_RAW_TAG_BYTES = 256;
+
+    bool is_space(char c) {
+        return c == ' ' || c == '\t' || c == '\n' || c == '\r';
+    }
+
+    bool is_name_start(char c) {
+        unsigned char u = static_cast<unsigned char>(c);
+        return std::isalpha(u) || c == '_' || c == ':' || u >= 0x80;
+    }
+
+    // Append a code point as UTF-8; false if it is not a valid character
+    bool append_utf8(std::string& out, std::uint32_t cp) {
+        if (cp == 0 || cp > 0x10FFFF || (cp >= 0xD800 && cp <= 0xDFFF)) return false;
+        if (cp < 0x80) {
+            out += static_cast<char>(cp);
+        } else if (cp < 0x800) {
+            out += static_cast<char>(0xC0 | (cp >> 6));
+            out += static_cast<char>(0x80 | (cp & 0x3F));
+        } else if (cp < 0x10000) {
+            out += static_cast<char>(0xE0 | (cp >> 12));
+            out += static_cast<char>(0x80 | ((cp >> 6) & 0x3F));
+            out += static_cast<char>(0x80 | (cp & 0x3F));
+        } else {
+            out += static_cast<char>(0xF0 | (cp >> 18));
+            out += static_cast<char>(0x80 | ((cp >> 12) & 0x3F));
+            out += static_cast<char>(0x80 | ((cp >> 6) & 0x3F));
+            out += static_cast<char>(0x80 | (cp & 0x3F));
+        }
+        return true;
+    }
+}
+
+// ==================== CONSTRUCTION ====================
+
+XMLStreamReader::XMLStreamReader(MessageCallback on_message, size_t max_field)
+    : callback(std::move(on_message)), max_field_bytes(max_field) {
+}
+
+// ==================== INPUT ====================
+
+void XMLStreamReader::feed(std::string_view chunk) {
+    for (char c : chunk) step(c);
+    report_text();
+}
+
+void XMLStreamReader::finish() {
+    if (state == State::Entity) {
+        append('&');
+        append(markup);
+    }
+    // A truncated document still delivers the message it was reading
+    if (message_depth >= 0 || field == Field::Text) {
+        if (!current.text.empty()) emit();
+    }
+
+    state = State::Content;
+    depth = 0;
+    message_depth = -1;
+    field = Field::None;
+    field_depth = -1;
+    current.clear();
+}
+
+void XMLStreamReader::read_all(std::istream& in) {
+    std::vector<char> buffer(READ_BUFFER_BYTES);
+    while (in.read(buffer.data(), static_cast<std::streamsize>(buffer.size())) || in.gcount() > 0) {
+        feed(std::string_view(buffer.data(), static_cast<size_t>(in.gcount())));
+    }
+    finish();
+}
+
+// ==================== TOKENIZER ====================
+
+void XMLStreamReader::step(char c) {
+    bool in_tag = state == State::StartTagName || state == State::StartTagRest ||
+                  state == State::EndTagName || state == State::EndTagRest;
+    if (in_tag && raw_tag.size() < MAX_RAW_TAG_BYTES) raw_tag += c;
+
+    switch (state) {
+        case State::Content:
+            if (c == '<') {
+                state = State::TagOpen;
+                name.clear();
+                raw_tag.assign(1, c);
+            } else if (c == '&') {
+                state = State::Entity;
+                markup.clear();
+            } else {
+                append(c);
+            }
+            break;
+
+        case State::TagOpen:
+            if (c == '/') {
+                state = State::EndTagName;
+                raw_tag += c;
+            } else if (c == '!') {
+                state = State::Markup;
+                markup.clear();
+            } else if (c == '?') {
+                state = State::ProcessingInstruction;
+                close_run = 0;
+            } else if (is_name_start(c)) {
+                state = State::StartTagName;
+                name += c;
+                raw_tag += c;
+            } else {
+                // Not markup: a stray '<' in content
+                append('<');
+                state = State::Content;
+                step(c);
+            }
+            break;
+
+        case State::StartTagName:
+            if (c == '>') {
+                open_element();
+                state = State::Content;
+            } else if (c == '/' || is_space(c)) {
+                state = State::StartTagRest;
+                slash_seen = (c == '/');
+                quote = 0;
+            } else if (name.size() < MAX_NAME_BYTES) {
+                name += c;
+            }
+            break;
+
+        case State::StartTagRest:
+            if (quote) {
+                if (c == quote) quote = 0;
+            } else if (c == '"' || c == '\'') {
+                quote = c;
+                slash_seen = false;
+            } else if (c == '>') {
+                bool literal = field == Field::Text;
+                open_element();
+                if (slash_seen && !literal) close_element();
+                state = State::Content;
+            } else if (c == '/') {
+                slash_seen = true;
+            } else if (!is_space(c)) {
+                slash_seen = false;
+            }
+            break;
+
+        case State::EndTagName:
+            if (c == '>') {
+                close_element();
+                state = State::Content;
+            } else if (is_space(c)) {
+                state = State::EndTagRest;
+            } else if (name.size() < MAX_NAME_BYTES) {
+                name += c;
+            }
+            break;
+
+        case State::EndTagRest:
+            if (c == '>') {
+                close_element();
+                state = State::Content;
+            }
+            break;
+
+        case State::Markup: {
+            markup += c;
+            std::string_view seen(markup);
+            std::string_view comment("--"), cdata("[CDATA[");
+            if (seen == comment) {
+                state = State::Comment;
+                close_run = 0;
+            } else if (seen == cdata) {
+                state = State::CData;
+                close_run = 0;
+            } else if (comment.substr(0, seen.size()) != seen &&
+                       cdata.substr(0, seen.size()) != seen) {
+                // <!DOCTYPE ...> or another declaration
+                state = c == '>' ? State::Content : State::Declaration;
+                decl_depth = c == '<' ? 1 : 0;
+            }
+            break;
+        }
+
+        case State::Comment:
+            if (c == '-') {
+                close_run++;
+            } else if (c == '>' && close_run >= 2) {
+                state = State::Content;
+            } else {
+                close_run = 0;
+            }
+            break;
+
+        case State::CData:
+            if (c == ']') {
+                close_run++;
+            } else if (c == '>' && close_run >= 2) {
+                for (int i = 2; i < close_run; i++) append(']');
+                state = State::Content;
+            } else {
+                for (int i = 0; i < close_run; i++) append(']');
+                close_run = 0;
+                append(c);
+            }
+            break;
+
+        case State::Declaration:
+            if (c == '<') {
+                decl_depth++;
+            } else if (c == '>') {
+                if (decl_depth == 0) state = State::Content;
+                else decl_depth--;
+            }
+            break;
+
+        case State::ProcessingInstruction:
+            if (c == '>' && close_run) {
+                state = State::Content;
+            } else {
+                close_run = (c == '?') ? 1 : 0;
+            }
+            break;
+
+        case State::Entity:
+            if (c == ';') {
+                flush_entity();
+                state = State::Content;
+            } else if (markup.size() < MAX_ENTITY_BYTES &&
+                       (std::isalnum(static_cast<unsigned char>(c)) || c == '#')) {
+                markup += c;
+            } else {
+                // Not an entity reference: keep the text as written
+                append('&');
+                append(markup);
+                state = State::Content;
+                step(c);
+            }
+            break;
+    }
+}
+
+void XMLStreamReader::flush_entity() {
+    if (markup == "lt") append('<');
+    else if (markup == "gt") append('>');
+    else if (markup == "amp") append('&');
+    else if (markup == "quot") append('"');
+    else if (markup == "apos") append('\'');
+    else {
+        std::string decoded;
+        bool ok = false;
+        if (markup.size() > 1 && markup[0] == '#') {
+            bool hex = markup[1] == 'x' || markup[1] == 'X';
+            const char* digits = markup.c_str() + (hex ? 2 : 1);
+            char* end = nullptr;
+            unsigned long cp = std::strtoul(digits, &end, hex ? 16 : 10);
+            ok = *digits != '\0' && *end == '\0' && append_utf8(decoded, static_cast<std::uint32_t>(cp));
+        }
+        if (ok) {
+            append(decoded);
+        } else {
+            // Unknown entity: keep it literally
+            append('&');
+            append(markup);
+            append(';');
+        }
+    }
+}
+
+// ==================== ELEMENTS ====================
+
+void XMLStreamReader::open_element() {
+    if (field == Field::Text) {
+        append(raw_tag);
+        return;
+    }
+    depth++;
+    if (name == "message" && message_depth < 0) {
+        message_depth = depth;
+        current.clear();
+    } else if (field == Field::None) {
+        if (name == "user") field = Field::User;
+        else if (name == "timestamp") field = Field::Timestamp;
+        else if (name == "text") field = Field::Text;
+        if (field != Field::None) {
+            field_depth = depth;
+            // Several <text> elements in one message are joined by a space
+            if (field == Field::Text && !current.text.empty()) append(' ');
+        }
+    }
+}
+
+void XMLStreamReader::close_element() {
+    if (field == Field::Text && name != "text") {
+        append(raw_tag);
+        return;
+    }
+    if (depth == 0) return;  // stray end tag
+
+    if (field != Field::None && depth == field_depth) {
+        bool standalone_text = field == Field::Text && message_depth < 0;
+        field = Field::None;
+        field_depth = -1;
+        if (standalone_text) {
+            emit();
+            current.clear();
+        }
+    }
+    if (depth == message_depth) {
+        emit();
+        message_depth = -1;
+        current.clear();
+    }
+    depth--;
+}
+
+void XMLStreamReader::append(char c) {
+    std::string* target = nullptr;
+    switch (field) {
+        case Field::User: target = &current.user; break;
+        case Field::Timestamp: target = &current.timestamp; break;
+        case Field::Text: target = &current.text; break;
+        case Field::None: return;
+    }
+    if (target->size() < max_field_bytes) *target += c;
+}
+
+void XMLStreamReader::append(std::string_view s) {
+    for (char c : s) append(c);
+}
+
+void XMLStreamReader::report_text() {
+    if (text_callback && current.text.size() > text_reported) {
+        text_callback(std::string_view(current.text).substr(text_reported));
+    }
+    text_reported = current.text.size();
+}
+
+void XMLStreamReader::emit() {
+    report_text();
+    message_count++;
+    if (callback) callback(current);
+    text_reported = 0;  // current is cleared next
+}
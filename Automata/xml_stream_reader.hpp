@@ -0,0 +1,131 @@
+#ifndef XML_STREAM_READER_HPP
+#define XML_STREAM_READER_HPP
+
+#include <string>
+#include <string_view>
+#include <functional>
+#include <istream>
+
+/**
+ * @struct XMLChatMessage
+ * @brief One <message> element of an exported chat log
+ */
+struct XMLChatMessage {
+    std::string user;       ///< <user> content (may be empty)
+    std::string timestamp;  ///< <timestamp> content (may be empty)
+    std::string text;       ///< <text> content, entities decoded
+
+    /// Empty the fields but keep their capacity for the next message
+    void clear() {
+        user.clear();
+        timestamp.clear();
+        text.clear();
+    }
+};
+
+/**
+ * @class XMLStreamReader
+ * @brief Push-based (SAX-style) reader for chat log XML
+ *
+ * Input is fed in arbitrary chunks; the tokenizer is a byte-at-a-time state
+ * machine, so tags, entities and CDATA sections may span chunk and line
+ * boundaries. Each <message> is delivered to the callback as soon as its
+ * closing tag is read, and only the fields of that one message are held in
+ * memory, so memory stays constant however long the log is. Field content
+ * beyond max_field_bytes is dropped.
+ *
+ * Handles comments, processing instructions, DOCTYPE, CDATA, the five
+ * predefined entities and numeric character references. A <text> outside
+ * any <message> is delivered as a message on its own. Chat text has no
+ * child elements, so tags inside <text> (an unescaped "<hate>") are kept
+ * literally as part of the text.
+ */
+class XMLStreamReader {
+public:
+    using MessageCallback = std::function<void(const XMLChatMessage&)>;
+    using TextCallback = std::function<void(std::string_view)>;
+
+    static constexpr size_t DEFAULT_MAX_FIELD_BYTES = 1u << 20;
+    static constexpr size_t READ_BUFFER_BYTES = 64u << 10;
+
+    explicit XMLStreamReader(MessageCallback on_message,
+                             size_t max_field_bytes = DEFAULT_MAX_FIELD_BYTES);
+
+    /**
+     * @brief Also hand out the current message's text as it is read
+     *
+     * on_text gets each new piece of XMLChatMessage::text: what a feed()
+     * added, at the end of that feed(), and the rest just before the
+     * message callback. The pieces of one message concatenate to its text,
+     * so it can be checked incrementally without waiting for the message.
+     */
+    void set_text_callback(TextCallback on_text) { text_callback = std::move(on_text); }
+
+    /**
+     * @brief Process the next chunk of the document
+     */
+    void feed(std::string_view chunk);
+
+    /**
+     * @brief Signal end of input; flushes a <text> left open at EOF
+     */
+    void finish();
+
+    /**
+     * @brief Read a whole stream through a fixed READ_BUFFER_BYTES buffer
+     */
+    void read_all(std::istream& in);
+
+    size_t messages_read() const { return message_count; }
+
+private:
+    enum class State {
+        Content,        // character data
+        TagOpen,        // after '<'
+        StartTagName,
+        StartTagRest,   // attributes, up to '>'
+        EndTagName,
+        EndTagRest,
+        Markup,         // after "<!"
+        Comment,        // inside <!-- -->
+        CData,          // inside <![CDATA[ ]]>
+        Declaration,    // <!DOCTYPE ...>, up to the matching '>'
+        ProcessingInstruction,
+        Entity          // after '&' in content
+    };
+
+    enum class Field { None, User, Timestamp, Text };
+
+    MessageCallback callback;
+    TextCallback text_callback;
+    size_t text_reported = 0;  // bytes of current.text already handed to text_callback
+    size_t max_field_bytes;
+    size_t message_count = 0;
+
+    State state = State::Content;
+    std::string name;         // tag name being read (bounded)
+    std::string markup;       // "<!" lookahead / entity name (bounded)
+    std::string raw_tag;      // bytes of the current tag (bounded)
+    char quote = 0;           // open attribute quote in StartTagRest
+    bool slash_seen = false;  // '/' just before '>' (self-closing tag)
+    int close_run = 0;        // consecutive closing chars seen in comment/CDATA/PI
+    int decl_depth = 0;       // nested '<' inside a declaration
+
+    // Element context
+    int depth = 0;
+    int message_depth = -1;   // depth of the open <message>, or -1
+    Field field = Field::None;
+    int field_depth = -1;     // depth of the open field element
+    XMLChatMessage current;
+
+    void step(char c);
+    void open_element();
+    void close_element();
+    void append(char c);
+    void append(std::string_view s);
+    void flush_entity();
+    void report_text();
+    void emit();
+};
+
+#endif // XML_STREAM_READER_HPP